@@ -0,0 +1,240 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "DisplayManager.h"
+#include "DecodeArena.h"
+
+// --- Animations-Pack (.ani): Animationen im Ladeformat des IconManagers ---
+// Aufbau (little endian):
+//   AnimPackHeader   20 Byte
+//   je Frame:        AnimFrameHeader, Run-Maske (DisplayManager::buildRunMask), Pixel-Delta
+// Pixel-Delta: Folge von (skip, count) als uint8 mit anschließend count RGB565-Pixeln, bezogen auf den
+// vorherigen Frame (Frame 0 auf einen schwarzen). Nur deckende Pixel zählen; was die Maske ausblendet,
+// bleibt im Puffer einfach liegen. Die Maske ersetzt den Alpha-Kanal (1 Bit, Schwelle wie beim Zeichnen).
+// Datensätze sind nicht ausgerichtet, Mehrbyte-Werte daher nur per memcpy lesen.
+struct AnimPackHeader {
+    char magic[4];          // "MANI"
+    uint8_t version;
+    uint8_t alphaThreshold;
+    uint16_t width;
+    uint16_t height;
+    uint16_t frameCount;
+    uint32_t sourceSize;    // Größe der Quelle (PNG-Sheet), 0 = ohne Quelle (Download)
+    uint32_t sourceParams;  // Aufteilung der Quelle (animPackParams), 0 = ohne Quelle
+};
+static_assert(sizeof(AnimPackHeader) == 20, "AnimPackHeader muss 20 Byte groß sein");
+
+struct AnimFrameHeader {
+    uint16_t delayMs;
+    uint16_t runBytes;
+    uint32_t deltaBytes;
+};
+static_assert(sizeof(AnimFrameHeader) == 8, "AnimFrameHeader muss 8 Byte groß sein");
+
+static const uint8_t ANIMPACK_VERSION = 1;
+
+// "/clear-day.png" -> "/clear-day.ani"
+static inline String animPackPath(const String& path) {
+    int dot = path.lastIndexOf('.');
+    int slash = path.lastIndexOf('/');
+    return (dot > slash ? path.substring(0, dot) : path) + ".ani";
+}
+
+static inline bool isAnimPack(const String& path) {
+    return path.endsWith(".ani") || path.endsWith(".ANI");
+}
+
+// Katalog-Angaben, mit denen das Sheet zerlegt wurde. Ändern sie sich, ist das Pack veraltet.
+static inline uint32_t animPackParams(uint16_t frameW, uint16_t delayMs, bool rotated) {
+    return ((uint32_t)frameW << 17) | ((uint32_t)delayMs << 1) | (rotated ? 1 : 0) | 0x80000000u;
+}
+
+// Liest ein Pack mit einem read in einen PSRAM-Block (Frame-Datensätze ohne Kopf).
+// expectedSource/expectedParams = 0: nicht prüfen. nullptr = fehlt, kaputt oder veraltet.
+static inline uint8_t* readAnimPack(const String& packPath, AnimPackHeader& header, size_t& size,
+                                    uint32_t expectedSource = 0, uint32_t expectedParams = 0) {
+    File f = LittleFS.open(packPath, "r");
+    if (!f) return nullptr;
+    bool ok = f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              memcmp(header.magic, "MANI", 4) == 0 && header.version == ANIMPACK_VERSION &&
+              header.width > 0 && header.height > 0 && header.frameCount > 0 &&
+              (expectedSource == 0 || header.sourceSize == expectedSource) &&
+              (expectedParams == 0 || header.sourceParams == expectedParams);
+    size = ok ? f.size() - sizeof(header) : 0;
+    uint8_t* data = ok && size ? (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM) : nullptr;
+    if (data && f.read(data, size) != size) { heap_caps_free(data); data = nullptr; }
+    f.close();
+    return data;
+}
+
+// Wendet ein Pixel-Delta auf frame (w * h) an
+static inline void applyAnimDelta(uint16_t* frame, size_t pixels, const uint8_t* delta, size_t bytes) {
+    const uint8_t* end = delta + bytes;
+    size_t pos = 0;
+    while (delta + 2 <= end) {
+        pos += delta[0];
+        size_t count = delta[1];
+        delta += 2;
+        if (pos + count > pixels || delta + count * 2 > end) return;
+        memcpy(frame + pos, delta, count * 2);
+        delta += count * 2;
+        pos += count;
+    }
+}
+
+// --- Schreiben: Frames nacheinander anhängen, Speicherbedarf ein Frame ---
+// Geschrieben wird in eine temporäre Datei, die erst bei finish() umbenannt wird. Ohne Pfad landen die
+// Frame-Datensätze nur im PSRAM (takeRecords()), z.B. wenn das Flash voll ist. Mit setScratch() kommen
+// Vorgänger- und Delta-Puffer aus der Decode-Arena des laufenden Auftrags.
+class AnimPackWriter {
+private:
+    File file;
+    uint8_t* mem = nullptr;      // Nur im Speicher: Frame-Datensätze ohne Kopf
+    size_t memSize = 0, memCap = 0;
+    bool toMemory = false;
+    String path;
+    String tmpPath;
+    AnimPackHeader header;
+    uint16_t* prev = nullptr;    // Rekonstruierter Vorgänger-Frame, genau wie ihn der Decoder sieht
+    uint8_t* delta = nullptr;
+    size_t deltaCap = 0;
+    DecodeScope* scratch = nullptr;
+    bool scratchBuffers = false; // prev/delta gehören der Arena
+    uint16_t written = 0;
+    uint32_t bytes = 0;
+    bool failed = false;
+
+    void release() {
+        if (!scratchBuffers) {
+            if (prev) heap_caps_free(prev);
+            if (delta) heap_caps_free(delta);
+        }
+        prev = nullptr; delta = nullptr;
+    }
+
+    bool write(const uint8_t* data, size_t n) {
+        if (!toMemory) return file.write(data, n) == n;
+        if (memSize + n > memCap) {
+            size_t cap = max(memCap * 2, memSize + n + 1024);
+            uint8_t* grown = (uint8_t*)heap_caps_realloc(mem, cap, MALLOC_CAP_SPIRAM);
+            if (!grown) return false;
+            mem = grown; memCap = cap;
+        }
+        memcpy(mem + memSize, data, n);
+        memSize += n;
+        return true;
+    }
+
+public:
+    ~AnimPackWriter() { abort(); }
+
+    // Arbeitspuffer der folgenden begin() aus der Arena (nullptr = Heap). Der Scope muss den Writer überdauern.
+    void setScratch(DecodeScope* scope) { scratch = scope; }
+
+    // packPath leer = nur im Speicher
+    bool begin(const String& packPath, uint16_t w, uint16_t h, uint16_t frames,
+               uint32_t sourceSize = 0, uint32_t sourceParams = 0, uint8_t threshold = 10) {
+        abort();
+        if (w == 0 || w > 255 || h == 0 || h > 255 || frames == 0) return false;
+        path = packPath;
+        tmpPath = packPath + ".tmp";
+        toMemory = packPath.length() == 0;
+        memcpy(header.magic, "MANI", 4);
+        header.version = ANIMPACK_VERSION;
+        header.alphaThreshold = threshold;
+        header.width = w; header.height = h;
+        header.frameCount = frames;
+        header.sourceSize = sourceSize;
+        header.sourceParams = sourceParams;
+
+        // Schlimmster Fall: jedes zweite Pixel geändert, je 2 Byte Steuerung + 2 Byte Pixel
+        size_t pixels = (size_t)w * h;
+        deltaCap = pixels * 4 + 4;
+        scratchBuffers = scratch != nullptr;
+        if (scratchBuffers) {
+            prev = scratch->alloc<uint16_t>(pixels, true);
+            delta = scratch->alloc<uint8_t>(deltaCap);
+        } else {
+            prev = (uint16_t*)heap_caps_calloc(pixels, sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+            delta = (uint8_t*)heap_caps_malloc(deltaCap, MALLOC_CAP_SPIRAM);
+        }
+        if (!toMemory) file = LittleFS.open(tmpPath, "w");
+        if (!prev || !delta || (!toMemory && !file)) { abort(); return false; }
+
+        failed = !toMemory && !write((const uint8_t*)&header, sizeof(header));
+        bytes = sizeof(header);
+        written = 0;
+        return !failed;
+    }
+
+    // Hängt den nächsten Frame an (RGB565 + Alpha, w * h)
+    bool addFrame(const uint16_t* pixels, const uint8_t* alpha, uint16_t delayMs) {
+        if (!prev || failed || written >= header.frameCount) return false;
+        size_t runSize = 0;
+        uint8_t* runs = DisplayManager::buildRunMask(alpha, header.width, header.height, header.alphaThreshold, &runSize);
+        if (!runs || runSize > 0xFFFF) { if (runs) heap_caps_free(runs); failed = true; return false; }
+
+        // Geänderte deckende Pixel als (skip, count, Pixel...) gegen prev
+        size_t n = (size_t)header.width * header.height;
+        uint8_t* p = delta;
+        size_t last = 0;    // Erstes Pixel nach dem letzten Lauf
+        for (size_t i = 0; i < n; ) {
+            if (alpha[i] <= header.alphaThreshold || pixels[i] == prev[i]) { i++; continue; }
+            size_t skip = i - last;
+            while (skip > 255) { *p++ = 255; *p++ = 0; skip -= 255; }
+            size_t start = i;
+            while (i < n && i - start < 255 && alpha[i] > header.alphaThreshold && pixels[i] != prev[i]) i++;
+            *p++ = (uint8_t)skip;
+            *p++ = (uint8_t)(i - start);
+            memcpy(p, pixels + start, (i - start) * 2);
+            memcpy(prev + start, pixels + start, (i - start) * 2);
+            p += (i - start) * 2;
+            last = i;
+        }
+
+        AnimFrameHeader fh = { delayMs, (uint16_t)runSize, (uint32_t)(p - delta) };
+        failed = !write((const uint8_t*)&fh, sizeof(fh)) || !write(runs, runSize) || !write(delta, fh.deltaBytes);
+        heap_caps_free(runs);
+        bytes += sizeof(fh) + runSize + fh.deltaBytes;
+        written++;
+        return !failed;
+    }
+
+    // Ersetzt ein vorhandenes Pack. False = unvollständig, nichts geschrieben.
+    bool finish() {
+        if (!prev) return false;
+        bool ok = !failed && written == header.frameCount;
+        release();
+        if (toMemory) {
+            if (!ok) abort();
+            return ok;
+        }
+        file.close();
+        if (ok) {
+            LittleFS.remove(path);
+            ok = LittleFS.rename(tmpPath, path);
+        }
+        if (!ok) LittleFS.remove(tmpPath);
+        return ok;
+    }
+
+    void abort() {
+        if (file) { file.close(); LittleFS.remove(tmpPath); }
+        if (mem) heap_caps_free(mem);
+        mem = nullptr; memSize = memCap = 0;
+        release();
+    }
+
+    // Nur im Speicher, nach finish(): übergibt die Frame-Datensätze an den Aufrufer
+    uint8_t* takeRecords(size_t& size) {
+        uint8_t* data = mem;
+        size = memSize;
+        mem = nullptr; memSize = memCap = 0;
+        return data;
+    }
+
+    const AnimPackHeader& getHeader() const { return header; }
+    uint16_t getWritten() const { return written; }
+    uint32_t getBytes() const { return bytes; }
+};
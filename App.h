@@ -17,4 +17,8 @@ public:
 
     // NEU: Globale Prio-Abfrage. Jede Standard-App hat Prio 3 (Normal).
     virtual int getPriority() { return 3; }
+
+    // Millisekunden ab now bis zur nächsten sichtbaren Änderung (0 = sofort).
+    // Der Loop schläft bis zur frühesten Deadline. Standard: jeder Frame wie beim alten Polling.
+    virtual uint32_t nextFrameDueMs(unsigned long now) { return FRAME_INTERVAL_MS; }
 };
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+#include <Arduino.h>
+#include "DisplayManager.h"
+#include "App.h"
+#include "RichText.h"
+#include "PlasmaApp.h"
+#include "IconManager.h"
+
+// --- Mess-Routinen für Render-Optimierungen (Trigger: MQTT matrix/cmd/benchmark) ---
+// Läuft synchron im Loop und blockiert die Anzeige für einige hundert Millisekunden.
+// Ergebnis geht als JSON auf matrix/status/benchmark und auf die serielle Konsole.
+class Benchmark {
+private:
+    static const int FRAMES = 50;
+
+    // Vergleicht den alten Weg (Fade beim Schreiben jedes Pixels) mit dem Fade-Pass im Compositor.
+    // Der Per-Pixel-Wert ist eine Untergrenze: früher kam bei Überzeichnung jeder Schreibzugriff dazu.
+    String benchFade(DisplayManager& display, App& app, const char* name) {
+        const uint32_t f = 16; // 50% Helligkeit, typischer Wert mitten in einer Überblendung
+        alignas(4) uint16_t row[M_WIDTH];
+        uint32_t tDraw = 0, tPixel = 0, tCompose = 0;
+        uint32_t sink = 0;
+
+        for (int i = 0; i < FRAMES; i++) {
+            uint32_t t0 = micros();
+            app.draw(display, true);
+            uint32_t t1 = micros();
+
+            uint16_t* buf = display.getAppBuffer();
+            if (!buf) break;
+            for (int16_t y = 0; y < M_HEIGHT; y++) {
+                memcpy(row, buf + y * M_WIDTH, sizeof(row));
+                for (int16_t x = 0; x < M_WIDTH; x++) row[x] = fadePixel565(row[x], f);
+                sink += row[y];
+            }
+            uint32_t t2 = micros();
+
+            for (int16_t y = 0; y < M_HEIGHT; y++) {
+                memcpy(row, buf + y * M_WIDTH, sizeof(row));
+                fadeRow565(row, M_WIDTH, f);
+                sink += row[y];
+            }
+            uint32_t t3 = micros();
+
+            tDraw += t1 - t0; tPixel += t2 - t1; tCompose += t3 - t2;
+        }
+
+        char json[160];
+        snprintf(json, sizeof(json), "\"%s\":{\"draw_us\":%lu,\"per_pixel_us\":%lu,\"compose_us\":%lu,\"chk\":%lu}",
+                 name, (unsigned long)(tDraw / FRAMES), (unsigned long)(tPixel / FRAMES),
+                 (unsigned long)(tCompose / FRAMES), (unsigned long)(sink & 0xFFFF));
+        return String(json);
+    }
+
+    // Text über u8g2 (pro Glyph Font-Suche + drawPixel) gegen den Glyph-Atlas, jeweils Messen + Zeichnen
+    String benchText(DisplayManager& display, const uint8_t* font, const char* name) {
+        const String sample = "Wohnzimmer 22.5°C | Luftfeuchte 45% | Tür offen";
+        uint32_t t[2] = {0, 0};
+
+        display.setU8g2Font(font);
+        for (int pass = 0; pass < 2; pass++) {
+            display.setGlyphAtlasEnabled(pass == 1);
+            uint32_t t0 = micros();
+            for (int i = 0; i < FRAMES; i++) {
+                int w = display.getTextWidth(sample);
+                display.drawString(M_WIDTH - (i * 4) % (w + M_WIDTH), 40, sample, 0xFFFF);
+            }
+            t[pass] = micros() - t0;
+        }
+        display.setGlyphAtlasEnabled(true);
+
+        char json[96];
+        snprintf(json, sizeof(json), "\"%s\":{\"u8g2_us\":%lu,\"atlas_us\":%lu}",
+                 name, (unsigned long)(t[0] / FRAMES), (unsigned long)(t[1] / FRAMES));
+        return String(json);
+    }
+
+    // Markup pro Frame parsen + zeichnen gegen einmal kompilierte Display-Liste abspielen
+    String benchRichText(DisplayManager& display) {
+        const String msg = "{c:mint}Matrix OS:{c:white}  Font Icons: {sun}{star}{arrow_u}  {b}Fett{b} {u}unterstrichen{u}  {c:gold}22.5°C {c:cyan}45%";
+        RichText rt;
+        RichTextList list = rt.compile(display, msg, "Medium");
+        // Achtfache Länge: mit Culling soll die Replay-Zeit nur von der sichtbaren Breite abhängen
+        String longMsg;
+        for (int i = 0; i < 8; i++) longMsg += msg + "  ";
+        RichTextList longList = rt.compile(display, longMsg, "Medium");
+        uint32_t t[3] = {0, 0, 0};
+
+        for (int pass = 0; pass < 3; pass++) {
+            uint32_t t0 = micros();
+            for (int i = 0; i < FRAMES; i++) {
+                int x = M_WIDTH - (i * 4) % (list.width + M_WIDTH);
+                if (pass == 0) rt.drawString(display, x, 38, msg, "Medium");
+                else if (pass == 1) rt.draw(display, x, 38, list);
+                else rt.draw(display, x - longList.width / 2, 38, longList);
+            }
+            t[pass] = micros() - t0;
+        }
+
+        char json[128];
+        snprintf(json, sizeof(json), "\"richtext\":{\"parse_us\":%lu,\"replay_us\":%lu,\"replay_8x_us\":%lu,\"spans\":%u}",
+                 (unsigned long)(t[0] / FRAMES), (unsigned long)(t[1] / FRAMES), (unsigned long)(t[2] / FRAMES),
+                 (unsigned)list.spans.size());
+        return String(json);
+    }
+
+    // Plasma mit RGB565-drawPixel gegen den indizierten Modus (draw + show inkl. DMA-Diff),
+    // dazu ein Frame, der nur die Palette rotiert und nichts neu zeichnet.
+    String benchPlasma(DisplayManager& display, PlasmaApp& plasma) {
+        uint32_t tDraw[2] = {0, 0}, tShow[2] = {0, 0};
+        for (int pass = 0; pass < 2; pass++) {
+            plasma.setIndexed(pass == 1);
+            for (int i = 0; i < FRAMES; i++) {
+                uint32_t t0 = micros();
+                plasma.draw(display, true);
+                uint32_t t1 = micros();
+                display.show();
+                tDraw[pass] += t1 - t0;
+                tShow[pass] += micros() - t1;
+            }
+        }
+        plasma.setIndexed(true);
+
+        uint32_t tRotate = 0;
+        if (display.isIndexed()) {
+            uint16_t base[256], rot[256];
+            for (int i = 0; i < 256; i++) base[i] = display.colorHSV(i * 256, 255, 255);
+            uint32_t t0 = micros();
+            for (int i = 0; i < FRAMES; i++) {
+                uint8_t shift = (i + 1) * 4;
+                memcpy(rot, base + shift, (256 - shift) * sizeof(uint16_t));
+                memcpy(rot + 256 - shift, base, shift * sizeof(uint16_t));
+                display.setPalette(rot);
+                display.show();
+            }
+            tRotate = micros() - t0;
+        }
+
+        char json[192];
+        snprintf(json, sizeof(json), "\"plasma\":{\"rgb_draw_us\":%lu,\"rgb_show_us\":%lu,\"idx_draw_us\":%lu,\"idx_show_us\":%lu,\"rotate_us\":%lu,\"idx_bytes\":%u}",
+                 (unsigned long)(tDraw[0] / FRAMES), (unsigned long)(tShow[0] / FRAMES),
+                 (unsigned long)(tDraw[1] / FRAMES), (unsigned long)(tShow[1] / FRAMES),
+                 (unsigned long)(tRotate / FRAMES), (unsigned)(display.isIndexed() ? M_WIDTH * M_HEIGHT : 0));
+        return String(json);
+    }
+
+    // Sheet-Kacheln: alter Weg (BMP: seek + read pro Zeile, PNG: Dekodieren bis zur Kachel) gegen Tile-Pack,
+    // Katalog-Animationen gegen Animations-Pack, GIF-Umwandlung
+    String benchIcons(IconManager& icons) {
+        String json = "\"sheets\":[";
+        for (uint16_t i = 0; i < icons.getSheetCount(); i++) {
+            if (i) json += ",";
+            json += icons.benchSheet(i, 8);
+        }
+        return json + "],\"anims\":" + icons.benchAnims() + ",\"gifs\":" + icons.benchGifs("/bench");
+    }
+
+public:
+    String run(DisplayManager& display, PlasmaApp& plasma, App& wordclock, IconManager& icons) {
+        Serial.println(F("Benchmark: Start"));
+        float oldFade = display.getAppFade() / 32.0f;
+        bool wasIndexed = display.isIndexed();
+        display.setAppFade(1.0);
+
+        // benchFade liest die RGB565-Ebene, Plasma deshalb über drawPixel zeichnen lassen
+        plasma.setIndexed(false);
+        String result = "{\"frames\":" + String(FRAMES) + ",\"fade\":{";
+        result += benchFade(display, plasma, "plasma");
+        plasma.setIndexed(true);
+        result += ",";
+        result += benchFade(display, wordclock, "wordclock");
+        result += "},\"text\":{";
+
+        GlyphAtlas& atlas = display.getGlyphAtlas();
+        atlas.resetStats();
+        result += benchText(display, u8g2_font_helvR12_tf, "helvR12");
+        result += ",";
+        result += benchText(display, u8g2_font_helvB12_tf, "helvB12");
+        uint32_t lookups = atlas.getHits() + atlas.getMisses();
+        result += ",\"hit_pct\":" + String(lookups ? atlas.getHits() * 100 / lookups : 0);
+        result += ",\"glyphs\":" + String(atlas.getGlyphCount());
+        result += ",\"arena\":" + String(atlas.getArenaUsed());
+        result += "},";
+        result += benchRichText(display);
+        result += ",";
+        result += benchPlasma(display, plasma);
+        result += ",";
+        result += benchIcons(icons);
+        result += "}";
+
+        // Läuft gerade keine indizierte App, zurück auf die RGB565-Ebene
+        if (!wasIndexed) display.endIndexed();
+        display.setAppFade(oldFade);
+        Serial.print(F("Benchmark: ")); Serial.println(result);
+        return result;
+    }
+};
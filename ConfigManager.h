@@ -43,6 +43,10 @@ struct SystemConfig {
     String ota_password = "otaflash";
     int startup_brightness = 150; 
     bool show_debug_overlay = false; // <--- NEU: Debug Overlay Schalter
+    int scroll_strip_max_kb = 96;    // Max. Größe eines vorgerenderten Lauftextes, darüber wird live gezeichnet
+    int icon_cache_kb = 512;         // Gemeinsames PSRAM-Budget für statische und animierte Icons
+    int decode_arena_kb = 128;       // Fester Arbeitsspeicher für das Dekodieren von Icons (PNG, BMP, GIF)
+    String icon_base_url = "https://developer.lametric.com/content/apps/icon_thumbs/"; // Quelle für numerische Icon-IDs
 };
 
 struct AutoConfig {
@@ -116,6 +120,10 @@ public:
             system.ota_password = sys["ota_password"] | system.ota_password;
             system.startup_brightness = sys["startup_brightness"] | system.startup_brightness; 
             system.show_debug_overlay = sys["show_debug_overlay"] | system.show_debug_overlay; // <--- NEU
+            system.scroll_strip_max_kb = sys["scroll_strip_max_kb"] | system.scroll_strip_max_kb;
+            system.icon_cache_kb = sys["icon_cache_kb"] | system.icon_cache_kb;
+            system.decode_arena_kb = sys["decode_arena_kb"] | system.decode_arena_kb;
+            system.icon_base_url = sys["icon_base_url"] | system.icon_base_url;
         }
 
         if (doc->containsKey("auto")) {
@@ -0,0 +1,102 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// --- Decode-Arena: Arbeitsspeicher für das Laden und Umwandeln von Icons ---
+// Ein einmal reservierter PSRAM-Block, aus dem Dateipuffer, Zeilen- und Streifenpuffer, Canvas und
+// ausgepackte Frames fortlaufend vergeben werden. Freigegeben wird nicht einzeln, sondern am Ende des
+// Auftrags auf einen Schlag (DecodeScope). Damit entstehen im PSRAM zwischen den Cache-Einträgen keine
+// Lücken von kurzlebigen Puffern mehr. Aufträge dürfen geschachtelt sein (Stapel): ein laufender
+// GIF-Download hält seinen Teil über mehrere Loop-Durchläufe, ein Sheet-Load dazwischen liegt darüber.
+// Was nicht mehr hineinpasst, wird abgewiesen (nullptr), nicht auf den freien Heap umgeleitet.
+class DecodeArena {
+private:
+    friend class DecodeScope;
+    static const size_t ALIGN = 4;
+
+    uint8_t* base = nullptr;
+    size_t capacity = 0;
+    size_t top = 0;
+    size_t peak = 0;           // Höchster Füllstand seit dem Start
+    uint32_t jobs = 0;
+    uint32_t rejected = 0;     // Abgewiesene Aufträge
+
+    void* take(size_t bytes, bool zero) {
+        size_t size = (bytes + ALIGN - 1) & ~(ALIGN - 1);
+        if (!base || size > capacity - top) return nullptr;
+        uint8_t* p = base + top;
+        top += size;
+        if (top > peak) peak = top;
+        if (zero) memset(p, 0, bytes);
+        return p;
+    }
+
+public:
+    ~DecodeArena() { if (base) heap_caps_free(base); }
+
+    // Einmal beim Start, solange der PSRAM noch am Stück frei ist
+    bool begin(size_t bytes) {
+        if (base) return true;
+        base = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        capacity = base ? bytes : 0;
+        top = 0;
+        return base != nullptr;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return top; }
+    size_t getPeak() const { return peak; }
+    uint32_t getJobs() const { return jobs; }
+    uint32_t getRejected() const { return rejected; }
+};
+
+// Ein Decode-Auftrag: alles, was darüber aus der Arena kommt, gilt bis close() bzw. zum Ende des Scopes.
+// Schlägt eine Anforderung fehl, wird der Auftrag einmal als abgewiesen gezählt und gemeldet. rejected()
+// unterscheidet das vom Dekodierfehler; oversize() = der Auftrag passt auch in die leere Arena nicht.
+class DecodeScope {
+private:
+    DecodeArena* arena = nullptr;
+    size_t mark = 0;
+    bool failed = false;
+    bool tooLarge = false;
+
+public:
+    DecodeScope() {}
+    explicit DecodeScope(DecodeArena& a) { open(a); }
+    ~DecodeScope() { close(); }
+    DecodeScope(const DecodeScope&) = delete;
+    DecodeScope& operator=(const DecodeScope&) = delete;
+
+    void open(DecodeArena& a) {
+        close();
+        arena = &a;
+        mark = a.top;
+        failed = tooLarge = false;
+        a.jobs++;
+    }
+
+    void close() {
+        if (arena && arena->top >= mark) arena->top = mark;
+        arena = nullptr;
+    }
+
+    bool isOpen() const { return arena != nullptr; }
+    bool rejected() const { return failed; }
+    bool oversize() const { return tooLarge; }
+
+    // count Elemente vom Typ T, zero = mit 0 gefüllt. nullptr = passt nicht (mehr) in die Arena.
+    template <typename T>
+    T* alloc(size_t count, bool zero = false) {
+        if (!arena) return nullptr;
+        size_t bytes = count * sizeof(T);
+        T* p = (T*)arena->take(bytes, zero);
+        if (!p && !failed) {
+            failed = true;
+            tooLarge = (arena->top - mark) + bytes > arena->capacity;
+            arena->rejected++;
+            Serial.printf("[ICON] Decode-Arena zu klein: %u Bytes angefordert, %u von %u frei\n",
+                          (unsigned)bytes, (unsigned)(arena->capacity - arena->top), (unsigned)arena->capacity);
+        }
+        return p;
+    }
+};
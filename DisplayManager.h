@@ -3,57 +3,90 @@
 #include <U8g2_for_Adafruit_GFX.h> 
 #include <Adafruit_GFX.h>
 #include "config.h"
+#include "GlyphAtlas.h"
+
+// --- Ebenen des Compositors (von unten nach oben) ---
+enum DisplayLayer { LAYER_APP, LAYER_OVERLAY, LAYER_HUD };
+
+// Transparenz-Schlüssel für Overlay- und HUD-Ebene (dunkelstes Blau, von Graustufen nie erzeugt)
+#define LAYER_TRANSPARENT 0x0001
 
 // --- Eigene PSRAM Canvas Klasse ---
 class PSRAMCanvas16 : public Adafruit_GFX {
 private:
     uint16_t *buffer;
-    uint32_t fadeInt = 256; 
 
-    uint16_t applyFade(uint16_t color) {
-        if (fadeInt >= 256) return color;
-        if (fadeInt == 0) return 0;
-        
-        uint32_t r = (color >> 11) & 0x1F;
-        uint32_t g = (color >> 5) & 0x3F;
-        uint32_t b = color & 0x1F;
-        
-        r = (r * fadeInt) >> 8;
-        g = (g * fadeInt) >> 8;
-        b = (b * fadeInt) >> 8;
-        
-        return (r << 11) | (g << 5) | b;
-    }
+    // --- Dirty-Tracking: pro Zeile der veränderte Spaltenbereich [dirtyMin, dirtyMax] ---
+    // dirtyMin > dirtyMax bedeutet: Zeile ist sauber
+    int16_t *dirtyMin;
+    int16_t *dirtyMax;
+    bool anyDirty = false;
 
 public:
     PSRAMCanvas16(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
         buffer = (uint16_t*)heap_caps_malloc(w * h * 2, MALLOC_CAP_SPIRAM);
+        dirtyMin = (int16_t*)heap_caps_malloc(h * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+        dirtyMax = (int16_t*)heap_caps_malloc(h * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+        clearDirty();
     }
     ~PSRAMCanvas16() { 
         if(buffer) heap_caps_free(buffer); 
+        if(dirtyMin) heap_caps_free(dirtyMin);
+        if(dirtyMax) heap_caps_free(dirtyMax);
     }
     uint16_t* getBuffer() { return buffer; }
-    
-    void setAppFade(float f) { 
-        fadeInt = (uint32_t)(f * 256.0f);
-        if (fadeInt > 256) fadeInt = 256;
+
+    // Markiert ein (bereits geclipptes oder ungeclipptes) Rechteck als verändert
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (!dirtyMin || !dirtyMax) return;
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > _width) w = _width - x;
+        if (y + h > _height) h = _height - y;
+        if (w <= 0 || h <= 0) return;
+        int16_t x1 = x + w - 1;
+        for (int16_t row = y; row < y + h; row++) {
+            if (x < dirtyMin[row]) dirtyMin[row] = x;
+            if (x1 > dirtyMax[row]) dirtyMax[row] = x1;
+        }
+        anyDirty = true;
+    }
+
+    void markAllDirty() { markDirty(0, 0, _width, _height); }
+
+    void clearDirty() {
+        if (!dirtyMin || !dirtyMax) return;
+        for (int16_t row = 0; row < _height; row++) { dirtyMin[row] = _width; dirtyMax[row] = -1; }
+        anyDirty = false;
+    }
+
+    bool isDirty() { return anyDirty; }
+
+    // Liefert false, wenn die Zeile seit dem letzten clearDirty() unverändert ist
+    bool getDirtySpan(int16_t row, int16_t& x0, int16_t& x1) {
+        if (!dirtyMin || !dirtyMax || row < 0 || row >= _height) return false;
+        x0 = dirtyMin[row]; x1 = dirtyMax[row];
+        return x0 <= x1;
     }
     
     void drawPixel(int16_t x, int16_t y, uint16_t color) override {
         if (x < 0 || y < 0 || x >= _width || y >= _height) return;
-        buffer[y * _width + x] = applyFade(color); 
+        buffer[y * _width + x] = color; 
+        if (x < dirtyMin[y]) dirtyMin[y] = x;
+        if (x > dirtyMax[y]) dirtyMax[y] = x;
+        anyDirty = true;
     }
     
     void fillScreen(uint16_t color) override {
         if(buffer) {
-            uint16_t fadedColor = applyFade(color);
-            uint8_t hi = fadedColor >> 8, lo = fadedColor & 0xFF;
+            uint8_t hi = color >> 8, lo = color & 0xFF;
             if(hi == lo) {
                 memset(buffer, lo, _width * _height * 2);
             } else {
                 uint32_t pixels = _width * _height;
-                for(uint32_t i=0; i<pixels; i++) buffer[i] = fadedColor;
+                for(uint32_t i=0; i<pixels; i++) buffer[i] = color;
             }
+            markAllDirty();
         }
     }
     
@@ -62,9 +95,9 @@ public:
         if(y < 0) { h += y; y = 0; }
         if(y + h > _height) { h = _height - y; }
         if(h <= 0) return;
-        uint16_t fadedColor = applyFade(color);
         uint16_t *ptr = buffer + y * _width + x;
-        for(int16_t i=0; i<h; i++) { *ptr = fadedColor; ptr += _width; }
+        for(int16_t i=0; i<h; i++) { *ptr = color; ptr += _width; }
+        markDirty(x, y, 1, h);
     }
     
     void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
@@ -72,23 +105,192 @@ public:
         if(x < 0) { w += x; x = 0; }
         if(x + w > _width) { w = _width - x; }
         if(w <= 0) return;
-        uint16_t fadedColor = applyFade(color);
         uint16_t *ptr = buffer + y * _width + x;
-        for(int16_t i=0; i<w; i++) { *ptr++ = fadedColor; }
+        for(int16_t i=0; i<w; i++) { *ptr++ = color; }
+        markDirty(x, y, w, 1);
     }
 };
 
+// --- App-Fade (Faktor 0..32, 32 = volle Helligkeit) ---
+// Skalare Variante für einzelne Pixel
+static inline uint16_t fadePixel565(uint16_t c, uint32_t f) {
+    uint32_t r = (((c >> 11) & 0x1F) * f) >> 5;
+    uint32_t g = (((c >> 5) & 0x3F) * f) >> 5;
+    uint32_t b = ((c & 0x1F) * f) >> 5;
+    return (r << 11) | (g << 5) | b;
+}
+
+// Zwei RGB565-Pixel pro 32-Bit-Wort: R, G und B beider Pixel liegen nach dem Maskieren
+// in getrennten 16-Bit-Hälften, so dass eine Multiplikation pro Kanal beide Pixel skaliert.
+static inline uint32_t fadePair565(uint32_t w, uint32_t f) {
+    uint32_t r = ((((w >> 11) & 0x001F001F) * f) >> 5) & 0x001F001F;
+    uint32_t g = ((((w >> 5) & 0x003F003F) * f) >> 5) & 0x003F003F;
+    uint32_t b = (((w & 0x001F001F) * f) >> 5) & 0x001F001F;
+    return (r << 11) | (g << 5) | b;
+}
+
+static inline void fadeRow565(uint16_t* p, int16_t n, uint32_t f) {
+    if (n <= 0 || f >= 32) return;
+    if (f == 0) { memset(p, 0, n * sizeof(uint16_t)); return; }
+    if (((uintptr_t)p & 2) != 0) { *p = fadePixel565(*p, f); p++; n--; }
+    for (; n >= 2; n -= 2, p += 2) {
+        uint32_t w;
+        memcpy(&w, p, 4);
+        w = fadePair565(w, f);
+        memcpy(p, &w, 4);
+    }
+    if (n) *p = fadePixel565(*p, f);
+}
+
+// Eine über der App liegende Ebene: Pixel mit LAYER_TRANSPARENT lassen die App durchscheinen,
+// dimRects dunkeln die darunterliegenden Ebenen beim Komponieren ab.
+struct CompositorLayer {
+    PSRAMCanvas16* canvas = nullptr;
+    int16_t minX = M_WIDTH, minY = M_HEIGHT, maxX = -1, maxY = -1; // Ausdehnung des Inhalts
+    static const uint8_t MAX_DIM_RECTS = 4;
+    int16_t dimX[MAX_DIM_RECTS], dimY[MAX_DIM_RECTS], dimW[MAX_DIM_RECTS], dimH[MAX_DIM_RECTS];
+    uint8_t dimCount = 0;
+
+    bool hasContent() { return (minX <= maxX) || dimCount > 0; }
+};
+
 class DisplayManager {
 private:
     MatrixPanel_I2S_DMA* dma;
-    PSRAMCanvas16* canvas; 
+    PSRAMCanvas16* canvas;  // App-Ebene (bleibt erhalten, bis die App selbst neu zeichnet)
+    PSRAMCanvas16* target;  // Aktuelles Zeichenziel (siehe setLayer)
+    DisplayLayer currentLayer;
+    CompositorLayer overlayLayer;
+    CompositorLayer hudLayer;
     U8G2_FOR_ADAFRUIT_GFX u8g2; 
 
+    // Text über den Glyph-Atlas (Fallback auf u8g2, falls kein PSRAM oder kein Font gesetzt)
+    GlyphAtlas glyphs;
+    const uint8_t* u8g2Font = nullptr;
+    bool atlasEnabled = true;
+
+    // Zeilenweise Beschädigung durch Overlay/HUD (wird in show() mit den App-Dirty-Spans vereinigt)
+    int16_t damageMin[M_HEIGHT];
+    int16_t damageMax[M_HEIGHT];
+
+    // App-Fade wird erst beim Komponieren angewendet, Apps zeichnen immer mit voller Helligkeit
+    uint8_t appFade;
+    uint8_t shownFade;
+
+    // Indizierter App-Modus: 8 Bit pro Pixel im PSRAM, die Palette (inkl. Fade) wird erst beim
+    // Komponieren aufgelöst. Eine Palettenrotation ändert 256 Einträge statt M_WIDTH * M_HEIGHT Pixel.
+    uint8_t* indexBuffer;
+    bool indexedMode;
+    bool paletteChanged;    // Palette seit dem letzten show() verändert
+    uint8_t paletteFade;    // Fade-Wert, mit dem fadedPalette berechnet wurde
+    uint16_t palette[256];
+    uint16_t fadedPalette[256];
+
+    // Spiegel dessen, was aktuell im DMA-Puffer steht (für den Frame-Diff in show())
+    uint16_t* frontBuffer;
+    bool frontValid;
+
+    // Zähler für gepushte Pixel (Messung der Dirty-Rect Ersparnis)
+    uint32_t lastPushedPixels;
+    uint32_t totalPushedPixels;
+    uint32_t shownFrames;
+
     uint8_t gammaTable[256];
     uint8_t baseBrightness;
 
+    bool useAtlas() { return atlasEnabled && u8g2Font && glyphs.isReady(); }
+
+    // Zeichnet UTF-8 Text aus dem Glyph-Atlas, liefert die Cursor-Position danach
+    int drawAtlasText(int x, int y, const char* s, uint16_t color) {
+        uint32_t cp;
+        while ((cp = GlyphAtlas::nextCodepoint(s)) != 0) {
+            if (x >= M_WIDTH) break;
+            const GlyphEntry* g = glyphs.get(u8g2Font, cp);
+            if (g->h && x + max(g->advance, g->inkW) > 0) fillRunMask(x + g->bx, y + g->by, glyphs.getRuns(g), g->h, color);
+            x += g->advance;
+        }
+        return x;
+    }
+
+    CompositorLayer* getLayer(DisplayLayer layer) {
+        if (layer == LAYER_OVERLAY) return &overlayLayer;
+        if (layer == LAYER_HUD) return &hudLayer;
+        return nullptr;
+    }
+
+    void addDamage(int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > M_WIDTH) w = M_WIDTH - x;
+        if (y + h > M_HEIGHT) h = M_HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+        int16_t x1 = x + w - 1;
+        for (int16_t row = y; row < y + h; row++) {
+            if (x < damageMin[row]) damageMin[row] = x;
+            if (x1 > damageMax[row]) damageMax[row] = x1;
+        }
+    }
+
+    // Überführt die Dirty-Spans einer Ebene in ihre Inhalts-Ausdehnung und in die Frame-Beschädigung
+    void foldLayerDirty(CompositorLayer& l) {
+        if (!l.canvas || !l.canvas->isDirty()) return;
+        for (int16_t y = 0; y < M_HEIGHT; y++) {
+            int16_t x0, x1;
+            if (!l.canvas->getDirtySpan(y, x0, x1)) continue;
+            if (x0 < damageMin[y]) damageMin[y] = x0;
+            if (x1 > damageMax[y]) damageMax[y] = x1;
+            if (x0 < l.minX) l.minX = x0;
+            if (x1 > l.maxX) l.maxX = x1;
+            if (y < l.minY) l.minY = y;
+            if (y > l.maxY) l.maxY = y;
+        }
+        l.canvas->clearDirty();
+    }
+
+    // Rechnet die Palette nur neu, wenn sich Einträge oder der Fade geändert haben
+    void refreshFadedPalette() {
+        if (!paletteChanged && paletteFade == appFade) return;
+        memcpy(fadedPalette, palette, sizeof(palette));
+        fadeRow565(fadedPalette, 256, appFade);
+        paletteFade = appFade;
+    }
+
+    // Eine Zeile aus App-Ebene, Abdunklungen und den transparenten Overlay/HUD-Ebenen zusammensetzen
+    void composeRow(int16_t y, int16_t x0, int16_t x1, uint16_t* out) {
+        if (indexedMode) {
+            // Fade steckt bereits in fadedPalette (refreshFadedPalette)
+            const uint8_t* src = indexBuffer + y * M_WIDTH;
+            for (int16_t x = x0; x <= x1; x++) out[x] = fadedPalette[src[x]];
+        } else {
+            memcpy(out + x0, canvas->getBuffer() + y * M_WIDTH + x0, (x1 - x0 + 1) * sizeof(uint16_t));
+            fadeRow565(out + x0, x1 - x0 + 1, appFade);
+        }
+
+        for (CompositorLayer* l : { &overlayLayer, &hudLayer }) {
+            if (!l->canvas || !l->hasContent()) continue;
+
+            for (uint8_t i = 0; i < l->dimCount; i++) {
+                if (y < l->dimY[i] || y >= l->dimY[i] + l->dimH[i]) continue;
+                int16_t a = max(x0, l->dimX[i]);
+                int16_t b = min(x1, (int16_t)(l->dimX[i] + l->dimW[i] - 1));
+                for (int16_t x = a; x <= b; x++) out[x] = (out[x] >> 2) & 0x39E7;
+            }
+
+            if (y < l->minY || y > l->maxY) continue;
+            int16_t a = max(x0, l->minX);
+            int16_t b = min(x1, l->maxX);
+            const uint16_t* src = l->canvas->getBuffer() + y * M_WIDTH;
+            for (int16_t x = a; x <= b; x++) {
+                if (src[x] != LAYER_TRANSPARENT) out[x] = src[x];
+            }
+        }
+    }
+
 public:
-    DisplayManager() : dma(nullptr), canvas(nullptr), baseBrightness(150) {
+    DisplayManager() : dma(nullptr), canvas(nullptr), target(nullptr), currentLayer(LAYER_APP), appFade(32), shownFade(32),
+                       indexBuffer(nullptr), indexedMode(false), paletteChanged(true), paletteFade(32), frontBuffer(nullptr), frontValid(false),
+                       lastPushedPixels(0), totalPushedPixels(0), shownFrames(0), baseBrightness(150) {
+        memset(palette, 0, sizeof(palette));
         const uint8_t minHardwareBright = 2; 
         const uint8_t maxHardwareBright = 255;
         const int inputMax = 242;
@@ -103,6 +305,7 @@ public:
                 gammaTable[i] = (uint8_t)val;
             }
         }
+        for (int y = 0; y < M_HEIGHT; y++) { damageMin[y] = M_WIDTH; damageMax[y] = -1; }
     }
 
     bool begin() {
@@ -121,10 +324,28 @@ public:
         
         canvas = new PSRAMCanvas16(M_WIDTH, M_HEIGHT);
         if (!canvas) return false; 
+
+        frontBuffer = (uint16_t*)heap_caps_malloc(M_WIDTH * M_HEIGHT * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        frontValid = false;
+
+        // Overlay- und HUD-Ebene benötigen den Front-Buffer zum Komponieren
+        if (frontBuffer) {
+            overlayLayer.canvas = new PSRAMCanvas16(M_WIDTH, M_HEIGHT);
+            hudLayer.canvas = new PSRAMCanvas16(M_WIDTH, M_HEIGHT);
+            for (CompositorLayer* l : { &overlayLayer, &hudLayer }) {
+                if (!l->canvas->getBuffer()) { delete l->canvas; l->canvas = nullptr; continue; }
+                l->canvas->fillScreen(LAYER_TRANSPARENT);
+                l->canvas->clearDirty();
+                l->canvas->setTextWrap(false);
+            }
+        }
+        target = canvas;
+        currentLayer = LAYER_APP;
         
         u8g2.begin(*canvas);                 
         u8g2.setFontMode(1); 
         u8g2.setFontDirection(0);
+        glyphs.begin();
         
         canvas->setTextWrap(false);
         dma->setTextWrap(false);
@@ -133,9 +354,13 @@ public:
         return true;
     }
 
-    void setU8g2Font(const uint8_t* font) { u8g2.setFont(font); }
+    void setU8g2Font(const uint8_t* font) { u8g2.setFont(font); u8g2Font = font; }
+
+    void drawString(int x, int y, const String& text, uint16_t color) { drawText(x, y, text.c_str(), color); }
 
-    void drawString(int x, int y, const String& text, uint16_t color) {
+    // Ohne String-Objekt (für vorkompilierte RichText-Listen)
+    void drawText(int x, int y, const char* text, uint16_t color) {
+        if (useAtlas()) { drawAtlasText(x, y, text, color); return; }
         u8g2.setFontMode(1); 
         u8g2.setForegroundColor(color); 
         u8g2.setCursor(x, y); 
@@ -143,68 +368,406 @@ public:
     }
 
     void drawCenteredString(int y, const String& text, uint16_t color) {
-        u8g2.setFontMode(1); 
-        u8g2.setForegroundColor(color);
-        int w = u8g2.getUTF8Width(text.c_str());
-        int x = (M_WIDTH - w) / 2;
-        u8g2.setCursor(x, y); 
-        u8g2.print(text);
+        int w = getTextWidth(text);
+        drawString((M_WIDTH - w) / 2, y, text, color);
     }
 
     void drawUnderlinedString(int y, const String& text, uint16_t color) {
-        u8g2.setFontMode(1); 
-        u8g2.setForegroundColor(color);
-        int w = u8g2.getUTF8Width(text.c_str());
+        int w = getTextWidth(text);
         int x = (M_WIDTH - w) / 2; 
-        u8g2.setCursor(x, y); 
-        u8g2.print(text);
-        if(canvas) canvas->drawFastHLine(x, y + 2, w, color);
+        drawString(x, y, text, color);
+        if(target) target->drawFastHLine(x, y + 2, w, color);
     }
 
-    int getTextWidth(const String& text) { return u8g2.getUTF8Width(text.c_str()); }
+    int getTextWidth(const String& text) { return getTextWidth(text.c_str()); }
+
+    int getTextWidth(const char* text) { 
+        if (useAtlas()) return glyphs.measure(u8g2Font, text);
+        return u8g2.getUTF8Width(text); 
+    }
+
+    // --- Glyph-Atlas ---
+    GlyphAtlas& getGlyphAtlas() { return glyphs; }
+    void setGlyphAtlasEnabled(bool on) { atlasEnabled = on; }
 
     void setAppFade(float f) {
         if (f < 0.0) f = 0.0; if (f > 1.0) f = 1.0;
-        if(canvas) canvas->setAppFade(f);
+        appFade = (uint8_t)(f * 32.0f + 0.5f);
     }
 
+    uint8_t getAppFade() { return appFade; }
+    uint16_t* getAppBuffer() { return canvas ? canvas->getBuffer() : nullptr; }
+
     void setBrightness(uint8_t b) {
         baseBrightness = b; updateHardwareBrightness();
     }
 
+    // --- Indizierter App-Modus (8 Bit pro Pixel + Palette) ---
+    // Schaltet die App-Ebene auf den Index-Puffer um und liefert ihn zurück (M_WIDTH * M_HEIGHT Bytes).
+    // Die App schreibt Indizes direkt hinein und meldet veränderte Bereiche mit markIndexedDirty().
+    // Zeichenbefehle (drawPixel, Text, ...) gehen weiterhin an die RGB565-Ebene und sind unsichtbar,
+    // solange der Modus aktiv ist. nullptr, wenn kein PSRAM frei ist (dann RGB565 zeichnen).
+    uint8_t* beginIndexed() {
+        if (!canvas) return nullptr;
+        if (!indexBuffer) {
+            indexBuffer = (uint8_t*)heap_caps_malloc(M_WIDTH * M_HEIGHT, MALLOC_CAP_SPIRAM);
+            if (!indexBuffer) return nullptr;
+            memset(indexBuffer, 0, M_WIDTH * M_HEIGHT);
+        }
+        if (!indexedMode) {
+            indexedMode = true;
+            canvas->markAllDirty();
+        }
+        return indexBuffer;
+    }
+
+    // Zurück zur RGB565-Ebene (beim App-Wechsel). Der Index-Puffer bleibt für den nächsten Aufruf reserviert.
+    void endIndexed() {
+        if (!indexedMode) return;
+        indexedMode = false;
+        if (canvas) canvas->markAllDirty();
+    }
+
+    bool isIndexed() { return indexedMode; }
+
+    // Setzt count Paletteneinträge ab start. Ändert sich etwas, wird der nächste Frame komplett neu komponiert.
+    void setPalette(const uint16_t* colors, uint16_t start = 0, uint16_t count = 256) {
+        if (!colors || start >= 256) return;
+        if (start + count > 256) count = 256 - start;
+        if (memcmp(palette + start, colors, count * sizeof(uint16_t)) == 0) return;
+        memcpy(palette + start, colors, count * sizeof(uint16_t));
+        paletteChanged = true;
+    }
+
+    // Dirty-Tracking des Index-Puffers läuft über die Spans der App-Ebene
+    void markIndexedDirty(int16_t x, int16_t y, int16_t w, int16_t h) { if (canvas) canvas->markDirty(x, y, w, h); }
+    void markIndexedDirty() { if (canvas) canvas->markAllDirty(); }
+
     void updateHardwareBrightness() {
         if (!dma) return;
         dma->setBrightness8(gammaTable[baseBrightness]);
     }
 
+    // --- Ebenen ---
+    // Alle Zeichenbefehle gehen an die aktuelle Ebene. Die App-Ebene bleibt erhalten, bis die App
+    // selbst neu zeichnet; Overlay und HUD werden erst in show() darübergelegt.
+    void setLayer(DisplayLayer layer) {
+        CompositorLayer* l = getLayer(layer);
+        PSRAMCanvas16* next = (l && l->canvas) ? l->canvas : canvas;
+        if (next == canvas) layer = LAYER_APP; // Fallback ohne Compositor
+        currentLayer = layer;
+        if (next != target) {
+            target = next;
+            if (target) u8g2.begin(*target);
+        }
+    }
+
+    DisplayLayer getCurrentLayer() { return currentLayer; }
+
+    // Setzt eine Overlay/HUD-Ebene komplett auf transparent zurück
+    void clearLayer(DisplayLayer layer) {
+        CompositorLayer* l = getLayer(layer);
+        if (!l || !l->canvas) { if (layer == LAYER_APP && canvas) canvas->fillScreen(0); return; }
+
+        foldLayerDirty(*l);
+        if (l->minX <= l->maxX) {
+            uint16_t* buf = l->canvas->getBuffer();
+            for (int16_t y = l->minY; y <= l->maxY; y++) {
+                uint16_t* ptr = buf + y * M_WIDTH;
+                for (int16_t x = l->minX; x <= l->maxX; x++) ptr[x] = LAYER_TRANSPARENT;
+            }
+            addDamage(l->minX, l->minY, l->maxX - l->minX + 1, l->maxY - l->minY + 1);
+        }
+        for (uint8_t i = 0; i < l->dimCount; i++) addDamage(l->dimX[i], l->dimY[i], l->dimW[i], l->dimH[i]);
+        l->dimCount = 0;
+        l->minX = M_WIDTH; l->minY = M_HEIGHT; l->maxX = -1; l->maxY = -1;
+    }
+    void clearLayer() { clearLayer(currentLayer); }
+
+    // Komponiert App, Overlay und HUD und überträgt nur die veränderten Bereiche in den DMA-Puffer.
+    // Innerhalb der beschädigten Spans wird zusätzlich gegen den Front-Buffer verglichen, damit
+    // Apps, die clear() aufrufen und identisch neu zeichnen, keine Pixel pushen.
     void show() { 
-        if(canvas && dma) {
-            dma->drawRGBBitmap(0, 0, canvas->getBuffer(), M_WIDTH, M_HEIGHT);
+        if(!canvas || !dma) return;
+        uint16_t* buf = canvas->getBuffer();
+
+        if (indexedMode) refreshFadedPalette();
+
+        if (!frontBuffer) {
+            if (indexedMode) {
+                alignas(4) uint16_t row[M_WIDTH];
+                for (int16_t y = 0; y < M_HEIGHT; y++) {
+                    composeRow(y, 0, M_WIDTH - 1, row);
+                    dma->drawRGBBitmap(0, y, row, M_WIDTH, 1);
+                }
+            } else if (appFade >= 32) {
+                dma->drawRGBBitmap(0, 0, buf, M_WIDTH, M_HEIGHT);
+            } else {
+                alignas(4) uint16_t row[M_WIDTH];
+                for (int16_t y = 0; y < M_HEIGHT; y++) {
+                    memcpy(row, buf + y * M_WIDTH, sizeof(row));
+                    fadeRow565(row, M_WIDTH, appFade);
+                    dma->drawRGBBitmap(0, y, row, M_WIDTH, 1);
+                }
+            }
+            lastPushedPixels = M_WIDTH * M_HEIGHT;
+        } else {
+            foldLayerDirty(overlayLayer);
+            foldLayerDirty(hudLayer);
+
+            bool full = !frontValid;
+            // Neuer Fade-Wert verändert jede Zeile, auch wenn die App nichts neu gezeichnet hat
+            bool fadeChanged = (appFade != shownFade);
+            shownFade = appFade;
+            // Gleiches gilt für eine neue Palette im indizierten Modus
+            if (indexedMode && paletteChanged) fadeChanged = true;
+            lastPushedPixels = 0;
+            alignas(4) uint16_t row[M_WIDTH];
+
+            for (int16_t y = 0; y < M_HEIGHT; y++) {
+                int16_t x0 = damageMin[y], x1 = damageMax[y];
+                int16_t a, b;
+                if (canvas->getDirtySpan(y, a, b)) { if (a < x0) x0 = a; if (b > x1) x1 = b; }
+                damageMin[y] = M_WIDTH; damageMax[y] = -1;
+                if (full || fadeChanged) { x0 = 0; x1 = M_WIDTH - 1; }
+                if (x0 > x1) continue;
+
+                composeRow(y, x0, x1, row);
+
+                uint16_t* dst = frontBuffer + y * M_WIDTH;
+                int16_t x = x0;
+                while (x <= x1) {
+                    while (!full && x <= x1 && row[x] == dst[x]) x++;
+                    if (x > x1) break;
+                    int16_t start = x;
+                    while (x <= x1 && (full || row[x] != dst[x])) { dst[x] = row[x]; x++; }
+                    dma->drawRGBBitmap(start, y, dst + start, x - start, 1);
+                    lastPushedPixels += x - start;
+                }
+            }
+            frontValid = true;
         }
+        if (indexedMode) paletteChanged = false;
+        canvas->clearDirty();
+        totalPushedPixels += lastPushedPixels;
+        shownFrames++;
+    }
+
+    // Kopiert das zuletzt gezeigte Bild (alle Ebenen, inkl. Fade) nach dst (M_WIDTH * M_HEIGHT).
+    // Ohne Front-Buffer wird der aktuelle Stand der Ebenen komponiert.
+    bool captureFrame(uint16_t* dst) {
+        if (!dst || !canvas) return false;
+        if (frontBuffer && frontValid) {
+            memcpy(dst, frontBuffer, M_WIDTH * M_HEIGHT * sizeof(uint16_t));
+        } else {
+            if (indexedMode) refreshFadedPalette();
+            for (int16_t y = 0; y < M_HEIGHT; y++) composeRow(y, 0, M_WIDTH - 1, dst + y * M_WIDTH);
+        }
+        return true;
     }
+
+    // --- Statistik: gepushte Pixel pro Frame ---
+    uint32_t getLastPushedPixels() { return lastPushedPixels; }
+    uint32_t getTotalPushedPixels() { return totalPushedPixels; }
+    uint32_t getShownFrames() { return shownFrames; }
     
-    void clear() { if(canvas) canvas->fillScreen(0); }
+    void clear() { 
+        if (currentLayer != LAYER_APP) { clearLayer(currentLayer); return; }
+        if(canvas) canvas->fillScreen(0); 
+    }
     
-    void drawPixel(int16_t x, int16_t y, uint16_t c) { if(canvas) canvas->drawPixel(x, y, c); }
-    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) { if(canvas) canvas->drawLine(x0, y0, x1, y1, c); }
-    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) { if(canvas) canvas->fillRect(x, y, w, h, c); }
-    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) { if(canvas) canvas->drawFastHLine(x, y, w, c); }
-    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) { if(canvas) canvas->drawFastVLine(x, y, h, c); }
-    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) { if(canvas) canvas->drawRect(x, y, w, h, c); }
+    void drawPixel(int16_t x, int16_t y, uint16_t c) { if(target) target->drawPixel(x, y, c); }
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) { if(target) target->drawLine(x0, y0, x1, y1, c); }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) { if(target) target->fillRect(x, y, w, h, c); }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) { if(target) target->drawFastHLine(x, y, w, c); }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) { if(target) target->drawFastVLine(x, y, h, c); }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) { if(target) target->drawRect(x, y, w, h, c); }
     
-    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) { if(canvas) canvas->fillCircle(x0, y0, r, c); }
-    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) { if(canvas) canvas->drawCircle(x0, y0, r, c); }
-    void fillEllipse(int16_t x0, int16_t y0, int16_t rx, int16_t ry, uint16_t c) { if(canvas) canvas->fillEllipse(x0, y0, rx, ry, c); }
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) { if(target) target->fillCircle(x0, y0, r, c); }
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) { if(target) target->drawCircle(x0, y0, r, c); }
+    void fillEllipse(int16_t x0, int16_t y0, int16_t rx, int16_t ry, uint16_t c) { if(target) target->fillEllipse(x0, y0, rx, ry, c); }
     
+    // --- Icon-Blitter ---
+    // Run-Maske für ein Bild mit Alpha-Kanal: pro Zeile [n, x0, len0, x1, len1, ...] mit n deckenden
+    // Läufen (alpha > threshold). Breite max. 255 Pixel. Liegt im PSRAM, Freigabe mit heap_caps_free.
+    static uint8_t* buildRunMask(const uint8_t* alpha, int w, int h, uint8_t threshold = 10, size_t* outSize = nullptr) {
+        if (!alpha || w <= 0 || h <= 0 || w > 255) return nullptr;
+        size_t size = 0;
+        for (int y = 0; y < h; y++) {
+            const uint8_t* a = alpha + y * w;
+            size++;
+            for (int x = 0; x < w; ) {
+                if (a[x] <= threshold) { x++; continue; }
+                while (x < w && a[x] > threshold) x++;
+                size += 2;
+            }
+        }
+        uint8_t* runs = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!runs) return nullptr;
+
+        uint8_t* p = runs;
+        for (int y = 0; y < h; y++) {
+            const uint8_t* a = alpha + y * w;
+            uint8_t* count = p++;
+            *count = 0;
+            for (int x = 0; x < w; ) {
+                if (a[x] <= threshold) { x++; continue; }
+                int start = x;
+                while (x < w && a[x] > threshold) x++;
+                *p++ = start; *p++ = x - start;
+                (*count)++;
+            }
+        }
+        if (outSize) *outSize = size;
+        return runs;
+    }
+
+    // Überspringt 'rows' Zeilen einer Run-Maske (z.B. für den Start eines Animations-Frames)
+    static const uint8_t* skipRunRows(const uint8_t* runs, int rows) {
+        while (rows-- > 0) runs += 1 + 2 * runs[0];
+        return runs;
+    }
+
+    // Kopiert nur die deckenden Läufe eines RGB565-Bildes in die aktuelle Ebene.
+    // Geclippt wird einmal pro Rechteck bzw. Lauf, scale = 2 verdoppelt jedes Pixel (LaMetric 8x8 -> 16x16).
+    void blitRGB565Masked(int x, int y, const uint16_t* pixels, int w, int h, const uint8_t* runs, uint8_t scale = 1) {
+        if (!target) return;
+        int16_t minX, maxX;
+        if (!blitRunsInto(target->getBuffer(), M_WIDTH, M_HEIGHT, x, y, pixels, w, h, runs, scale, minX, maxX)) return;
+        int dh = h * (scale == 2 ? 2 : 1);
+        int cy0 = y < 0 ? 0 : y;
+        int cy1 = y + dh > M_HEIGHT ? M_HEIGHT : y + dh;
+        target->markDirty(minX, cy0, maxX - minX + 1, cy1 - cy0);
+    }
+
+    // Kern des Blitters für beliebige Zielpuffer (z.B. Scroll-Strips). Liefert die beschriebenen Spalten.
+    static bool blitRunsInto(uint16_t* buf, int bufW, int bufH, int x, int y, const uint16_t* pixels, int w, int h,
+                             const uint8_t* runs, uint8_t scale, int16_t& minX, int16_t& maxX) {
+        minX = bufW; maxX = -1;
+        if (!buf || !pixels || !runs || w <= 0 || h <= 0) return false;
+        if (scale != 2) scale = 1;
+        int dw = w * scale, dh = h * scale;
+        if (x >= bufW || y >= bufH || x + dw <= 0 || y + dh <= 0) return false;
+
+        for (int sy = 0; sy < h; sy++, runs += 1 + 2 * runs[0]) {
+            int dy = y + sy * scale;
+            if (dy + scale <= 0) continue;
+            if (dy >= bufH) break;
+
+            const uint16_t* src = pixels + sy * w;
+            uint8_t n = runs[0];
+            const uint8_t* r = runs + 1;
+
+            for (uint8_t i = 0; i < n; i++, r += 2) {
+                int dx0 = x + r[0] * scale;
+                int dx1 = dx0 + r[1] * scale;   // exklusiv
+                int cx0 = dx0 < 0 ? 0 : dx0;
+                int cx1 = dx1 > bufW ? bufW : dx1;
+                if (cx0 >= cx1) continue;
+                if (cx0 < minX) minX = cx0;
+                if (cx1 - 1 > maxX) maxX = cx1 - 1;
+
+                if (scale == 1) {
+                    memcpy(buf + dy * bufW + cx0, src + (cx0 - x), (cx1 - cx0) * sizeof(uint16_t));
+                    continue;
+                }
+
+                // 2x: erste Zielzeile pixelweise verdoppeln, zweite Zeile als Span kopieren
+                bool top = dy >= 0, bottom = dy + 1 < bufH;
+                uint16_t* row = buf + (top ? dy : dy + 1) * bufW;
+                for (int dx = cx0; dx < cx1; dx++) row[dx] = src[(dx - x) >> 1];
+                if (top && bottom) memcpy(row + bufW + cx0, row + cx0, (cx1 - cx0) * sizeof(uint16_t));
+            }
+        }
+        return minX <= maxX;
+    }
+
+    // Kopiert einen Ausschnitt eines Bildes mit Schlüsselfarbe (z.B. Fenster eines Scroll-Strips).
+    // Pixel mit 'key' bleiben durchsichtig, der Rest wird zeilenweise als Span kopiert.
+    void blitRGB565Keyed(int x, int y, const uint16_t* src, int srcStride, int w, int h, uint16_t key) {
+        if (!target || !src || w <= 0 || h <= 0) return;
+        if (x < 0) { src -= x; w += x; x = 0; }
+        if (y < 0) { src -= y * srcStride; h += y; y = 0; }
+        if (x + w > M_WIDTH) w = M_WIDTH - x;
+        if (y + h > M_HEIGHT) h = M_HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+
+        uint16_t* buf = target->getBuffer();
+        for (int row = 0; row < h; row++) {
+            const uint16_t* s = src + row * srcStride;
+            uint16_t* d = buf + (y + row) * M_WIDTH + x;
+            int i = 0;
+            while (i < w) {
+                while (i < w && s[i] == key) i++;
+                int start = i;
+                while (i < w && s[i] != key) i++;
+                if (i > start) memcpy(d + start, s + start, (i - start) * sizeof(uint16_t));
+            }
+        }
+        target->markDirty(x, y, w, h);
+    }
+
+    // Leitet alle Zeichenbefehle vorübergehend auf eine eigene Canvas (M_WIDTH x M_HEIGHT) um
+    void beginOffscreen(PSRAMCanvas16* c) {
+        if (!c || !c->getBuffer()) return;
+        target = c;
+        u8g2.begin(*target);
+    }
+
+    void endOffscreen() {
+        CompositorLayer* l = getLayer(currentLayer);
+        target = (l && l->canvas) ? l->canvas : canvas;
+        if (target) u8g2.begin(*target);
+    }
+
+    // Füllt die Läufe einer Run-Maske einfarbig (Glyphen aus dem Atlas)
+    void fillRunMask(int x, int y, const uint8_t* runs, int h, uint16_t color) {
+        if (!target || !runs || h <= 0 || y >= M_HEIGHT || y + h <= 0) return;
+        uint16_t* buf = target->getBuffer();
+        int16_t minX = M_WIDTH, maxX = -1;
+
+        for (int sy = 0; sy < h; sy++, runs += 1 + 2 * runs[0]) {
+            int dy = y + sy;
+            if (dy < 0) continue;
+            if (dy >= M_HEIGHT) break;
+            uint16_t* row = buf + dy * M_WIDTH;
+            const uint8_t* r = runs + 1;
+            for (uint8_t i = 0; i < runs[0]; i++, r += 2) {
+                int cx0 = x + r[0], cx1 = cx0 + r[1];
+                if (cx0 < 0) cx0 = 0;
+                if (cx1 > M_WIDTH) cx1 = M_WIDTH;
+                if (cx0 >= cx1) continue;
+                for (int dx = cx0; dx < cx1; dx++) row[dx] = color;
+                if (cx0 < minX) minX = cx0;
+                if (cx1 - 1 > maxX) maxX = cx1 - 1;
+            }
+        }
+        if (minX <= maxX) target->markDirty(minX, y, maxX - minX + 1, h);
+    }
+
+    // Auf der App-Ebene wird direkt abgedunkelt, auf Overlay/HUD wird das Rechteck erst beim
+    // Komponieren auf die darunterliegenden Ebenen angewendet.
     void dimRect(int x, int y, int w, int h) {
         if (!canvas) return;
         
-        if (x < 0) x = 0;
-        if (y < 0) y = 0;
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
         if (x + w > M_WIDTH) w = M_WIDTH - x;
         if (y + h > M_HEIGHT) h = M_HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+
+        CompositorLayer* l = getLayer(currentLayer);
+        if (l && l->canvas) {
+            if (l->dimCount >= CompositorLayer::MAX_DIM_RECTS) return;
+            l->dimX[l->dimCount] = x; l->dimY[l->dimCount] = y;
+            l->dimW[l->dimCount] = w; l->dimH[l->dimCount] = h;
+            l->dimCount++;
+            addDamage(x, y, w, h);
+            return;
+        }
         
         uint16_t* buffer = canvas->getBuffer();
+        canvas->markDirty(x, y, w, h);
         
         for (int j = y; j < y + h; j++) {
             for (int i = x; i < x + w; i++) {
@@ -224,35 +787,27 @@ public:
         }
     }
     
-    void setTextColor(uint16_t c) { if(canvas) canvas->setTextColor(c); }
-    void setCursor(int16_t x, int16_t y) { if(canvas) canvas->setCursor(x, y); }
+    void setTextColor(uint16_t c) { if(target) target->setTextColor(c); }
+    void setCursor(int16_t x, int16_t y) { if(target) target->setCursor(x, y); }
     
     // --- OPTIMIERUNG: Null-Allocation Print Überladungen ---
-    void print(const String& t) { if(canvas) canvas->print(t); }
-    void print(const char* t) { if(canvas) canvas->print(t); }
-    void print(const __FlashStringHelper* t) { if(canvas) canvas->print(t); }
-    void print(int t) { if(canvas) canvas->print(t); }
-    void print(uint32_t t) { if(canvas) canvas->print(t); }
-    void print(long t) { if(canvas) canvas->print(t); }
+    void print(const String& t) { if(target) target->print(t); }
+    void print(const char* t) { if(target) target->print(t); }
+    void print(const __FlashStringHelper* t) { if(target) target->print(t); }
+    void print(int t) { if(target) target->print(t); }
+    void print(uint32_t t) { if(target) target->print(t); }
+    void print(long t) { if(target) target->print(t); }
     
-    void setTextSize(uint8_t s) { if(canvas) canvas->setTextSize(s); }
-    void setFont(const GFXfont *f = NULL) { if(canvas) canvas->setFont(f); }
-    void setTextWrap(bool w) { if(canvas) canvas->setTextWrap(w); }
+    void setTextSize(uint8_t s) { if(target) target->setTextSize(s); }
+    void setFont(const GFXfont *f = NULL) { if(target) target->setFont(f); }
+    void setTextWrap(bool w) { if(target) target->setTextWrap(w); }
     
     void printCentered(const String& text, int y) {
-        u8g2.setFontMode(1); 
-        u8g2.setForegroundColor(0xFFFF); 
-        int w = u8g2.getUTF8Width(text.c_str());
-        int x = (M_WIDTH - w) / 2;
-        u8g2.setCursor(x, y); 
-        u8g2.print(text);
+        drawCenteredString(y, text, 0xFFFF);
     }
 
     void drawScrollingText(const String& text, int y, int xPos, uint16_t color) {
-        u8g2.setFontMode(1); 
-        u8g2.setForegroundColor(color);
-        u8g2.setCursor(xPos, y);
-        u8g2.print(text);
+        drawString(xPos, y, text, color);
     }
 
     uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return dma->color565(r, g, b); }
@@ -0,0 +1,202 @@
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <U8g2_for_Adafruit_GFX.h>
+#include <esp_heap_caps.h>
+
+// --- Erfassungsfläche: u8g2 zeichnet einen einzelnen Glyph hinein (1 Bit pro Pixel) ---
+class GlyphCaptureGFX : public Adafruit_GFX {
+public:
+    static const int16_t W = 64;
+    static const int16_t H = 48;
+    static const int16_t ORIGIN_X = 16;   // Cursor-Position beim Erfassen
+    static const int16_t BASELINE_Y = 36; // Grundlinie beim Erfassen
+
+    uint8_t bits[W * H / 8];
+    int16_t minX, minY, maxX, maxY;
+
+    GlyphCaptureGFX() : Adafruit_GFX(W, H) { reset(); }
+
+    void reset() {
+        memset(bits, 0, sizeof(bits));
+        minX = W; minY = H; maxX = -1; maxY = -1;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || y < 0 || x >= W || y >= H) return;
+        bits[(y * W + x) >> 3] |= (0x80 >> (x & 7));
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+    }
+
+    bool get(int16_t x, int16_t y) const { return bits[(y * W + x) >> 3] & (0x80 >> (x & 7)); }
+};
+
+// Ein gecachter Glyph. Die Maske liegt als Run-Liste im Arena-Speicher
+// (pro Zeile [n, x0, len0, ...], gleiches Format wie die Icon-Masken).
+struct GlyphEntry {
+    const uint8_t* font;  // nullptr = freier Slot
+    uint32_t cp;          // Unicode Code Point
+    uint32_t runs;        // Offset im Arena-Speicher
+    int8_t bx, by;        // Versatz der Maske zu Cursor bzw. Grundlinie
+    uint8_t h;            // Zeilen der Maske (0 = kein sichtbares Pixel, z.B. Leerzeichen)
+    uint8_t advance;      // Cursor-Vorschub
+    uint8_t inkW;         // Breite, die u8g2 für den letzten Glyph eines Strings rechnet
+};
+
+// --- PSRAM Glyph-Atlas ---
+// Jeder (Font, Glyph) wird beim ersten Gebrauch einmal über u8g2 gerastert. Danach werden
+// Zeichnen und Messen komplett aus dem Cache bedient, ohne die Font-Daten erneut zu durchsuchen.
+// Läuft Tabelle oder Arena voll, wird der Atlas komplett geleert und neu aufgebaut.
+class GlyphAtlas {
+private:
+    static const uint16_t SLOTS = 1024;            // Zweierpotenz, Füllgrad max. 75%
+    static const uint32_t ARENA_SIZE = 48 * 1024;
+
+    GlyphEntry* table = nullptr;
+    uint8_t* arena = nullptr;
+    uint32_t arenaUsed = 0;
+    uint16_t used = 0;
+
+    GlyphCaptureGFX* capture = nullptr;
+    U8G2_FOR_ADAFRUIT_GFX u8g2;
+    const uint8_t* captureFont = nullptr;
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t flushes = 0;
+
+    static uint16_t slotFor(const uint8_t* font, uint32_t cp) {
+        uint32_t h = ((uint32_t)(uintptr_t)font * 2654435761u) ^ (cp * 40503u);
+        return (h ^ (h >> 16)) & (SLOTS - 1);
+    }
+
+    static uint8_t encodeUtf8(uint32_t cp, char* out) {
+        if (cp < 0x80) { out[0] = cp; out[1] = 0; return 1; }
+        if (cp < 0x800) { out[0] = 0xC0 | (cp >> 6); out[1] = 0x80 | (cp & 0x3F); out[2] = 0; return 2; }
+        out[0] = 0xE0 | (cp >> 12); out[1] = 0x80 | ((cp >> 6) & 0x3F); out[2] = 0x80 | (cp & 0x3F); out[3] = 0;
+        return 3;
+    }
+
+    GlyphEntry* rasterize(GlyphEntry* slot, const uint8_t* font, uint32_t cp) {
+        if (font != captureFont) { u8g2.setFont(font); captureFont = font; }
+        capture->reset();
+        int16_t adv = u8g2.drawGlyph(GlyphCaptureGFX::ORIGIN_X, GlyphCaptureGFX::BASELINE_Y, cp);
+        char utf8[5];
+        encodeUtf8(cp, utf8);
+        int16_t ink = u8g2.getUTF8Width(utf8);
+
+        // Größe der Run-Liste bestimmen
+        uint32_t size = 0;
+        int16_t rows = (capture->maxY >= capture->minY) ? capture->maxY - capture->minY + 1 : 0;
+        for (int16_t y = capture->minY; y < capture->minY + rows; y++) {
+            size++;
+            for (int16_t x = capture->minX; x <= capture->maxX; ) {
+                if (!capture->get(x, y)) { x++; continue; }
+                while (x <= capture->maxX && capture->get(x, y)) x++;
+                size += 2;
+            }
+        }
+        if (arenaUsed + size > ARENA_SIZE || used >= SLOTS * 3 / 4) {
+            flush();
+            slot = &table[slotFor(font, cp)];
+        }
+        while (slot->font) slot = &table[(slot - table + 1) & (SLOTS - 1)];
+
+        slot->font = font;
+        slot->cp = cp;
+        slot->runs = arenaUsed;
+        slot->bx = rows ? capture->minX - GlyphCaptureGFX::ORIGIN_X : 0;
+        slot->by = rows ? capture->minY - GlyphCaptureGFX::BASELINE_Y : 0;
+        slot->h = rows;
+        slot->advance = adv > 0 ? adv : 0;
+        slot->inkW = ink > 0 ? ink : 0;
+        used++;
+
+        uint8_t* p = arena + arenaUsed;
+        for (int16_t y = capture->minY; y < capture->minY + rows; y++) {
+            uint8_t* count = p++;
+            *count = 0;
+            for (int16_t x = capture->minX; x <= capture->maxX; ) {
+                if (!capture->get(x, y)) { x++; continue; }
+                int16_t start = x;
+                while (x <= capture->maxX && capture->get(x, y)) x++;
+                *p++ = start - capture->minX; *p++ = x - start;
+                (*count)++;
+            }
+        }
+        arenaUsed += size;
+        return slot;
+    }
+
+public:
+    bool begin() {
+        table = (GlyphEntry*)heap_caps_malloc(SLOTS * sizeof(GlyphEntry), MALLOC_CAP_SPIRAM);
+        arena = (uint8_t*)heap_caps_malloc(ARENA_SIZE, MALLOC_CAP_SPIRAM);
+        capture = new GlyphCaptureGFX();
+        if (!table || !arena || !capture) return false;
+        u8g2.begin(*capture);
+        u8g2.setFontMode(1);
+        u8g2.setFontDirection(0);
+        u8g2.setForegroundColor(1);
+        flush();
+        flushes = 0;
+        return true;
+    }
+
+    bool isReady() { return table && arena && capture; }
+
+    void flush() {
+        if (table) memset(table, 0, SLOTS * sizeof(GlyphEntry));
+        arenaUsed = 0;
+        used = 0;
+        flushes++;
+    }
+
+    // Liefert den Glyph aus dem Cache und rastert ihn beim ersten Zugriff.
+    // Der Zeiger ist nur bis zum nächsten get() gültig (ein Miss kann den Atlas leeren).
+    const GlyphEntry* get(const uint8_t* font, uint32_t cp) {
+        GlyphEntry* slot = &table[slotFor(font, cp)];
+        while (slot->font) {
+            if (slot->font == font && slot->cp == cp) { hits++; return slot; }
+            slot = &table[(slot - table + 1) & (SLOTS - 1)];
+        }
+        misses++;
+        return rasterize(slot, font, cp);
+    }
+
+    const uint8_t* getRuns(const GlyphEntry* g) { return arena + g->runs; }
+
+    // Dekodiert den nächsten UTF-8 Code Point, 0 = Ende
+    static uint32_t nextCodepoint(const char*& s) {
+        uint8_t c = *s;
+        if (!c) return 0;
+        s++;
+        if (c < 0x80) return c;
+        int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+        uint32_t cp = c & (0x3F >> extra);
+        while (extra-- > 0 && (*s & 0xC0) == 0x80) cp = (cp << 6) | (*s++ & 0x3F);
+        return cp;
+    }
+
+    // Entspricht getUTF8Width: Vorschub aller Glyphen, beim letzten die tatsächliche Tintenbreite
+    int measure(const uint8_t* font, const char* s) {
+        int w = 0, lastAdv = 0, lastInk = 0;
+        uint32_t cp;
+        while ((cp = nextCodepoint(s)) != 0) {
+            const GlyphEntry* g = get(font, cp);
+            w += g->advance;
+            lastAdv = g->advance; lastInk = g->inkW;
+        }
+        return w - lastAdv + lastInk;
+    }
+
+    uint32_t getHits() { return hits; }
+    uint32_t getMisses() { return misses; }
+    uint32_t getFlushes() { return flushes; }
+    uint16_t getGlyphCount() { return used; }
+    uint32_t getArenaUsed() { return arenaUsed; }
+    void resetStats() { hits = 0; misses = 0; }
+};
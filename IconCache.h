@@ -0,0 +1,299 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Stabiler Verweis auf einen Cache-Eintrag: (Generation << 16) | (Slot + 1), 0 = ungültig.
+// Wird der Eintrag verdrängt, steigt die Generation des Slots und alte Handles laufen ins Leere,
+// statt auf freigegebenen Speicher zu zeigen.
+typedef uint32_t IconHandle;
+
+// Icon wird im Hintergrund geladen; der IconManager liefert dafür einen Platzhalter.
+// Kein Cache-Slot passt dazu, IconCache::get() gibt also nullptr zurück und der Name wird neu aufgelöst.
+static const IconHandle ICON_PENDING = 0xFFFFFFFFu;
+
+static inline uint32_t iconNameHash(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+    return h;
+}
+
+// --- Hash-indizierter LRU-Cache für geladene Icons ---
+// T braucht 'String name', 'size_t bytes' und 'unsigned long lastUsed'. Suche über verkettete
+// Buckets, LRU-Liste und Kette liegen als Indizes in der Slot-Tabelle (PSRAM), alles O(1).
+// Der Cache gibt nichts selbst frei: popLRU() liefert den verdrängten Eintrag an den Aufrufer,
+// damit der IconManager das Byte-Budget über beide Caches hinweg durchsetzen kann.
+template <typename T>
+class IconCache {
+public:
+    static const uint16_t SLOTS = 256;     // Max. Einträge
+    static const uint16_t BUCKETS = 512;   // Zweierpotenz
+
+private:
+    struct Node {
+        T* item;          // nullptr = frei
+        uint32_t hash;
+        uint16_t gen;
+        int16_t prev, next;  // LRU: head = zuletzt benutzt
+        int16_t chain;       // Nächster Eintrag im Bucket bzw. in der Frei-Liste
+    };
+
+    Node* nodes = nullptr;
+    int16_t* buckets = nullptr;
+    int16_t head = -1, tail = -1, freeList = -1;
+    uint16_t count = 0;
+    size_t bytes = 0;
+    uint32_t hits = 0, misses = 0, evictions = 0;
+
+    void unlinkLRU(int16_t i) {
+        Node& n = nodes[i];
+        if (n.prev >= 0) nodes[n.prev].next = n.next; else head = n.next;
+        if (n.next >= 0) nodes[n.next].prev = n.prev; else tail = n.prev;
+        n.prev = n.next = -1;
+    }
+
+    void pushFront(int16_t i) {
+        nodes[i].prev = -1;
+        nodes[i].next = head;
+        if (head >= 0) nodes[head].prev = i;
+        head = i;
+        if (tail < 0) tail = i;
+    }
+
+    void touch(int16_t i) {
+        nodes[i].item->lastUsed = millis();
+        if (i == head) return;
+        unlinkLRU(i);
+        pushFront(i);
+    }
+
+    static IconHandle makeHandle(int16_t i, uint16_t gen) { return ((uint32_t)gen << 16) | (uint32_t)(i + 1); }
+
+    int16_t slotOf(IconHandle h) const {
+        if (!nodes || !h) return -1;
+        int16_t i = (int16_t)((h & 0xFFFF) - 1);
+        if (i < 0 || i >= SLOTS || !nodes[i].item || nodes[i].gen != (h >> 16)) return -1;
+        return i;
+    }
+
+    T* removeAt(int16_t i) {
+        Node& n = nodes[i];
+        int16_t* link = &buckets[n.hash & (BUCKETS - 1)];
+        while (*link != i) link = &nodes[*link].chain;
+        *link = n.chain;
+        unlinkLRU(i);
+
+        T* item = n.item;
+        bytes -= item->bytes;
+        count--;
+        n.item = nullptr;
+        n.gen++;
+        if (n.gen == 0) n.gen = 1;
+        n.chain = freeList;
+        freeList = i;
+        return item;
+    }
+
+public:
+    bool begin() {
+        if (nodes) return true;
+        nodes = (Node*)heap_caps_malloc(SLOTS * sizeof(Node), MALLOC_CAP_SPIRAM);
+        buckets = (int16_t*)heap_caps_malloc(BUCKETS * sizeof(int16_t), MALLOC_CAP_SPIRAM);
+        if (!nodes || !buckets) return false;
+        for (uint16_t b = 0; b < BUCKETS; b++) buckets[b] = -1;
+        freeList = -1;
+        for (int16_t i = SLOTS - 1; i >= 0; i--) {
+            nodes[i].item = nullptr;
+            nodes[i].gen = 1;
+            nodes[i].prev = nodes[i].next = -1;
+            nodes[i].chain = freeList;
+            freeList = i;
+        }
+        return true;
+    }
+
+    // Sucht per Name; Treffer wandert an den Anfang der LRU-Liste
+    IconHandle find(const char* name, uint32_t hash) {
+        if (!nodes) return 0;
+        for (int16_t i = buckets[hash & (BUCKETS - 1)]; i >= 0; i = nodes[i].chain) {
+            if (nodes[i].hash == hash && nodes[i].item->name == name) {
+                touch(i);
+                hits++;
+                return makeHandle(i, nodes[i].gen);
+            }
+        }
+        misses++;
+        return 0;
+    }
+
+    // Wie find(), aber ohne LRU-Update und Zählung
+    bool contains(const char* name, uint32_t hash) const {
+        if (!nodes) return false;
+        for (int16_t i = buckets[hash & (BUCKETS - 1)]; i >= 0; i = nodes[i].chain) {
+            if (nodes[i].hash == hash && nodes[i].item->name == name) return true;
+        }
+        return false;
+    }
+
+    // Löst ein Handle in O(1) auf, nullptr wenn der Eintrag inzwischen verdrängt wurde
+    T* get(IconHandle h) {
+        int16_t i = slotOf(h);
+        if (i < 0) return nullptr;
+        touch(i);
+        hits++;
+        return nodes[i].item;
+    }
+
+    // Wie get(), aber ohne LRU-Update und Zählung (direkt nach find()/insert())
+    T* item(IconHandle h) const {
+        int16_t i = slotOf(h);
+        return i < 0 ? nullptr : nodes[i].item;
+    }
+
+    // Nimmt einen Eintrag auf. Vorher mit full() prüfen und ggf. popLRU() aufrufen.
+    IconHandle insert(T* item, uint32_t hash) {
+        if (!nodes || freeList < 0) return 0;
+        int16_t i = freeList;
+        Node& n = nodes[i];
+        freeList = n.chain;
+        n.item = item;
+        n.hash = hash;
+        n.chain = buckets[hash & (BUCKETS - 1)];
+        buckets[hash & (BUCKETS - 1)] = i;
+        pushFront(i);
+        item->lastUsed = millis();
+        bytes += item->bytes;
+        count++;
+        return makeHandle(i, n.gen);
+    }
+
+    // Entfernt den am längsten unbenutzten Eintrag und gibt ihn zum Freigeben zurück
+    T* popLRU() {
+        if (tail < 0) return nullptr;
+        evictions++;
+        return removeAt(tail);
+    }
+
+    // Entfernt alle Einträge; free wird für jeden aufgerufen
+    template <typename F>
+    void clear(F free) {
+        while (tail >= 0) free(removeAt(tail));
+    }
+
+    bool full() const { return freeList < 0; }
+    bool empty() const { return count == 0; }
+    // lastUsed des LRU-Kandidaten (für die Verdrängung über mehrere Caches)
+    unsigned long oldestUse() const { return tail >= 0 ? nodes[tail].item->lastUsed : 0; }
+
+    // --- Statistik ---
+    uint16_t getCount() const { return count; }
+    size_t getBytes() const { return bytes; }
+    uint32_t getHits() const { return hits; }
+    uint32_t getMisses() const { return misses; }
+    uint32_t getEvictions() const { return evictions; }
+};
+
+// Grund eines fehlgeschlagenen Lookups
+enum IconMiss : uint8_t {
+    MISS_NONE = 0,
+    MISS_NOT_FOUND,   // Weder im Katalog noch im Dateisystem, bzw. HTTP 4xx
+    MISS_DECODE,      // Datei vorhanden, aber nicht lesbar/konvertierbar
+    MISS_NETWORK,     // Kein WLAN, Timeout oder HTTP 5xx: vorübergehend
+    MISS_BUSY         // Decode-Arena gerade belegt (z.B. laufende GIF-Umwandlung): kurz warten
+};
+
+// --- Negativ-Cache für fehlgeschlagene Icon-Lookups ---
+// Feste Tabelle (Hash, lineares Sondieren über wenige Slots), Speicher bleibt konstant.
+// Jeder Eintrag sperrt den Namen bis retryAt; danach darf genau ein neuer Versuch laufen.
+// Netzwerkfehler verdoppeln die Wartezeit bei jedem weiteren Fehlschlag, ein Erfolg löscht den Eintrag.
+// Ist die Tabelle voll, wird der Eintrag überschrieben, dessen Sperre am frühesten endet.
+class IconMissCache {
+public:
+    static const uint16_t SLOTS = 64;      // Zweierpotenz
+    static const uint8_t PROBES = 4;
+    static const uint32_t NOT_FOUND_TTL_MS = 30UL * 60 * 1000;
+    static const uint32_t NETWORK_BASE_MS = 5000;
+    static const uint32_t NETWORK_MAX_MS = 10UL * 60 * 1000;
+    static const uint32_t BUSY_TTL_MS = 1000;
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint32_t retryAt;    // millis()
+        uint8_t reason;      // IconMiss, MISS_NONE = frei
+        uint8_t failures;    // Fehlschläge in Folge
+        bool anim;
+    };
+
+    Entry entries[SLOTS];
+    uint32_t blockedCount = 0;
+
+    static bool expired(const Entry& e, uint32_t now) { return (int32_t)(now - e.retryAt) >= 0; }
+
+    Entry* lookup(uint32_t hash, bool anim) {
+        for (uint8_t p = 0; p < PROBES; p++) {
+            Entry& e = entries[(hash + p) & (SLOTS - 1)];
+            if (e.reason != MISS_NONE && e.hash == hash && e.anim == anim) return &e;
+        }
+        return nullptr;
+    }
+
+public:
+    IconMissCache() { clear(); }
+
+    void clear() { memset(entries, 0, sizeof(entries)); }
+
+    // true = Name ist noch gesperrt, kein neuer Ladeversuch
+    bool blocked(uint32_t hash, bool anim) {
+        Entry* e = lookup(hash, anim);
+        if (!e || expired(*e, millis())) return false;
+        blockedCount++;
+        return true;
+    }
+
+    // Merkt einen Fehlschlag und gibt die Sperrzeit in ms zurück
+    uint32_t record(uint32_t hash, bool anim, IconMiss reason) {
+        uint32_t now = millis();
+        Entry* e = lookup(hash, anim);
+        uint8_t failures = 1;
+        if (e) {
+            if (e->failures < 255) failures = e->failures + 1;
+        } else {
+            // Freien Slot nehmen, sonst den, dessen Sperre am frühesten endet
+            for (uint8_t p = 0; p < PROBES; p++) {
+                Entry& c = entries[(hash + p) & (SLOTS - 1)];
+                if (c.reason == MISS_NONE) { e = &c; break; }
+                if (!e || (int32_t)(c.retryAt - e->retryAt) < 0) e = &c;
+            }
+        }
+
+        uint32_t ttl = NOT_FOUND_TTL_MS;
+        if (reason == MISS_BUSY) ttl = BUSY_TTL_MS;
+        else if (reason == MISS_NETWORK) {
+            uint8_t shift = failures - 1 < 7 ? failures - 1 : 7;
+            ttl = NETWORK_BASE_MS << shift;
+            if (ttl > NETWORK_MAX_MS) ttl = NETWORK_MAX_MS;
+        }
+
+        e->hash = hash;
+        e->anim = anim;
+        e->reason = reason;
+        e->failures = failures;
+        e->retryAt = now + ttl;
+        return ttl;
+    }
+
+    // Nach erfolgreichem Laden: Backoff zurücksetzen
+    void forget(uint32_t hash, bool anim) {
+        Entry* e = lookup(hash, anim);
+        if (e) e->reason = MISS_NONE;
+    }
+
+    // --- Statistik ---
+    uint16_t getCount() const {
+        uint32_t now = millis();
+        uint16_t n = 0;
+        for (uint16_t i = 0; i < SLOTS; i++) if (entries[i].reason != MISS_NONE && !expired(entries[i], now)) n++;
+        return n;
+    }
+    uint32_t getBlocked() const { return blockedCount; }
+};
@@ -0,0 +1,228 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+
+#ifndef SPIRAM_ALLOCATOR_DEFINED
+#define SPIRAM_ALLOCATOR_DEFINED
+struct SpiRamAllocator {
+  void* allocate(size_t size) { return heap_caps_malloc(size, MALLOC_CAP_SPIRAM); }
+  void deallocate(void* pointer) { heap_caps_free(pointer); }
+  void* reallocate(void* ptr, size_t new_size) { return heap_caps_realloc(ptr, new_size, MALLOC_CAP_SPIRAM); }
+};
+using SpiRamJsonDocument = BasicJsonDocument<SpiRamAllocator>;
+#endif
+
+// Sheet bzw. Animation aus /catalog.json. Alle Texte sind Offsets in den Namens-Pool (siehe IconCatalog::str).
+struct CatalogSheet {
+    uint32_t file;
+    uint16_t cols;
+    uint16_t rows;
+};
+
+struct CatalogAnim {
+    uint32_t file;
+    uint16_t frameW;
+    uint16_t delayMs;
+    bool rotated;
+};
+
+// --- PSRAM-Index über /catalog.json ---
+// Der Katalog wird einmal geparst und in einen kompakten Index übersetzt: alle Namen liegen
+// hintereinander in einem Pool, Icons, Animationen und Aliase stehen in einer gemeinsamen
+// Hash-Tabelle (FNV-1a, lineares Sondieren, Füllgrad max. 50%). Ein Cache-Miss im IconManager
+// kostet damit einen Hash und wenige strcmp statt eines kompletten JSON-Parse.
+class IconCatalog {
+public:
+    enum Kind : uint8_t { KIND_ICON = 1, KIND_ANIM, KIND_ALIAS };
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t name;   // Offset im Pool
+        uint32_t value;  // Icon: (Sheet << 16) | Index, Animation: Index in anims, Alias: Offset des Ziels
+        uint8_t kind;    // 0 = frei
+    };
+
+    char* pool = nullptr;
+    uint32_t poolUsed = 0;
+    Slot* slots = nullptr;
+    uint32_t slotCount = 0;     // Zweierpotenz
+    CatalogSheet* sheets = nullptr;
+    uint16_t sheetCount = 0;
+    CatalogAnim* anims = nullptr;
+    uint16_t animCount = 0;
+    uint16_t iconCount = 0;
+    uint16_t aliasCount = 0;
+    uint32_t loadMs = 0;
+
+    static uint32_t hashName(const char* s, Kind kind) {
+        uint32_t h = 2166136261u ^ kind;
+        while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+        return h;
+    }
+
+    void release() {
+        if (pool) heap_caps_free(pool);
+        if (slots) heap_caps_free(slots);
+        if (sheets) heap_caps_free(sheets);
+        if (anims) heap_caps_free(anims);
+        pool = nullptr; slots = nullptr; sheets = nullptr; anims = nullptr;
+        poolUsed = 0; slotCount = 0; sheetCount = 0; animCount = 0; iconCount = 0; aliasCount = 0;
+    }
+
+    // Legt s im Pool ab (Pool ist beim Aufbau so groß wie die Datei, jeder Text stammt daraus)
+    uint32_t intern(const char* s, uint32_t poolCap) {
+        size_t n = strlen(s) + 1;
+        if (poolUsed + n > poolCap) return 0;
+        uint32_t off = poolUsed;
+        memcpy(pool + off, s, n);
+        poolUsed += n;
+        return off;
+    }
+
+    const Slot* find(const char* name, Kind kind) const {
+        if (!slots || !name) return nullptr;
+        uint32_t h = hashName(name, kind);
+        for (uint32_t i = h & (slotCount - 1); slots[i].kind; i = (i + 1) & (slotCount - 1)) {
+            const Slot& s = slots[i];
+            if (s.hash == h && s.kind == kind && strcmp(pool + s.name, name) == 0) return &s;
+        }
+        return nullptr;
+    }
+
+    bool insert(const char* name, Kind kind, uint32_t value, uint32_t poolCap) {
+        if (find(name, kind)) return false;
+        uint32_t h = hashName(name, kind);
+        uint32_t i = h & (slotCount - 1);
+        while (slots[i].kind) i = (i + 1) & (slotCount - 1);
+        slots[i].hash = h;
+        slots[i].name = intern(name, poolCap);
+        slots[i].value = value;
+        slots[i].kind = kind;
+        return true;
+    }
+
+    // Baut den Index aus einem geparsten Dokument. Icons mit unbekanntem Sheet werden übersprungen.
+    bool build(JsonDocument& doc, uint32_t poolCap) {
+        JsonObject jSheets = doc["sheets"];
+        JsonObject jAnims = doc["animations"];
+        JsonObject jIcons = doc["icons"];
+        JsonObject jAliases = doc["aliases"];
+
+        size_t total = jAnims.size() + jIcons.size() + jAliases.size();
+        slotCount = 16;
+        while (slotCount < total * 2) slotCount <<= 1;
+
+        pool = (char*)heap_caps_malloc(poolCap, MALLOC_CAP_SPIRAM);
+        slots = (Slot*)heap_caps_calloc(slotCount, sizeof(Slot), MALLOC_CAP_SPIRAM);
+        if (jSheets.size()) sheets = (CatalogSheet*)heap_caps_malloc(jSheets.size() * sizeof(CatalogSheet), MALLOC_CAP_SPIRAM);
+        if (jAnims.size()) anims = (CatalogAnim*)heap_caps_malloc(jAnims.size() * sizeof(CatalogAnim), MALLOC_CAP_SPIRAM);
+        if (!pool || !slots || (jSheets.size() && !sheets) || (jAnims.size() && !anims)) return false;
+
+        for (JsonPair kv : jSheets) {
+            CatalogSheet& s = sheets[sheetCount++];
+            s.file = intern(kv.value()["file"] | "", poolCap);
+            s.cols = kv.value()["cols"] | 1;
+            s.rows = kv.value()["rows"] | 0;
+        }
+
+        for (JsonPair kv : jAnims) {
+            CatalogAnim& a = anims[animCount];
+            a.file = intern(kv.value()["file"] | "", poolCap);
+            a.frameW = kv.value()["frame_width"] | 16;
+            a.delayMs = kv.value()["delay"] | 100;
+            a.rotated = kv.value()["rotated"] | false;
+            if (insert(kv.key().c_str(), KIND_ANIM, animCount, poolCap)) animCount++;
+        }
+
+        for (JsonPair kv : jIcons) {
+            const char* sheetName = kv.value()["sheet"] | "";
+            int sheet = 0;
+            for (JsonPair s : jSheets) {
+                if (strcmp(s.key().c_str(), sheetName) == 0) break;
+                sheet++;
+            }
+            if (sheet >= sheetCount) continue;
+            uint16_t index = kv.value()["index"] | 0;
+            if (insert(kv.key().c_str(), KIND_ICON, ((uint32_t)sheet << 16) | index, poolCap)) iconCount++;
+        }
+
+        for (JsonPair kv : jAliases) {
+            // Ziele sind meist LaMetric-IDs als Zahl ("wetter": 2356)
+            String target = kv.value().as<String>();
+            if (insert(kv.key().c_str(), KIND_ALIAS, intern(target.c_str(), poolCap), poolCap)) aliasCount++;
+        }
+
+        // Pool auf die tatsächlich belegte Größe kürzen
+        char* shrunk = (char*)heap_caps_realloc(pool, poolUsed ? poolUsed : 1, MALLOC_CAP_SPIRAM);
+        if (shrunk) pool = shrunk;
+        return true;
+    }
+
+public:
+    ~IconCatalog() { release(); }
+
+    // Liest den Katalog neu ein. Fehlt die Datei, ist der Index leer (kein Fehler).
+    bool load(const char* path = "/catalog.json") {
+        uint32_t t0 = millis();
+        release();
+        if (!LittleFS.exists(path)) { loadMs = millis() - t0; return true; }
+        File f = LittleFS.open(path, "r");
+        if (!f) return false;
+        size_t fileSize = f.size();
+
+        // ArduinoJson kopiert Schlüssel und Werte aus dem Stream; bei Platzmangel mit doppelter Kapazität neu versuchen
+        bool ok = false;
+        for (size_t capacity = max((size_t)8192, fileSize * 2); capacity <= fileSize * 8 + 8192; capacity *= 2) {
+            SpiRamJsonDocument* doc = new SpiRamJsonDocument(capacity);
+            f.seek(0);
+            DeserializationError err = deserializeJson(*doc, f);
+            if (!err) ok = build(*doc, fileSize + 1);
+            delete doc;
+            if (err != DeserializationError::NoMemory) break;
+        }
+        f.close();
+        if (!ok) release();
+        loadMs = millis() - t0;
+
+        Serial.printf("Katalog: %u Icons, %u Animationen, %u Aliase, %u Bytes, %lu ms\n",
+                      iconCount, animCount, aliasCount, (unsigned)getBytes(), (unsigned long)loadMs);
+        return ok;
+    }
+
+    bool findIcon(const char* name, const CatalogSheet*& sheet, uint16_t& index) const {
+        const Slot* s = find(name, KIND_ICON);
+        if (!s) return false;
+        sheet = &sheets[s->value >> 16];
+        index = s->value & 0xFFFF;
+        return true;
+    }
+
+    const CatalogAnim* findAnim(const char* name) const {
+        const Slot* s = find(name, KIND_ANIM);
+        return s ? &anims[s->value] : nullptr;
+    }
+
+    // Ziel eines Alias oder nullptr
+    const char* findAlias(const char* name) const {
+        const Slot* s = find(name, KIND_ALIAS);
+        return s ? pool + s->value : nullptr;
+    }
+
+    const char* str(uint32_t offset) const { return pool ? pool + offset : ""; }
+
+    uint16_t getSheetCount() const { return sheetCount; }
+    const CatalogSheet& getSheet(uint16_t i) const { return sheets[i]; }
+    const CatalogAnim& getAnim(uint16_t i) const { return anims[i]; }
+
+    // --- Statistik ---
+    uint16_t getIconCount() const { return iconCount; }
+    uint16_t getAnimCount() const { return animCount; }
+    uint16_t getAliasCount() const { return aliasCount; }
+    uint32_t getLoadMs() const { return loadMs; }
+    size_t getBytes() const {
+        return poolUsed + slotCount * sizeof(Slot) + sheetCount * sizeof(CatalogSheet) + animCount * sizeof(CatalogAnim);
+    }
+};
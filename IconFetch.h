@@ -0,0 +1,270 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include <LittleFS.h>
+#include <atomic>
+
+// --- Verbindungsaufbau in einer eigenen Task ---
+// DNS, TCP-Connect, TLS-Handshake und das Absenden der Anfrage blockieren. Das läuft daher nicht in
+// loop(), sondern in einer kurzlebigen Task, die den fertigen Client zurückgibt. Gibt loop() vorher auf
+// (cancel, Timeout), räumt die Task das Objekt selbst ab, sobald ihr connect() zurückkehrt.
+struct FetchConnect {
+    enum : int { RUNNING, DONE, ABANDONED };
+
+    WiFiClient plain;
+    WiFiClientSecure secure;
+    String host;
+    String request;
+    uint16_t port = 0;
+    bool tls = false;
+    bool ok = false;
+    std::atomic<int> state{RUNNING};
+
+    WiFiClient* client() { return tls ? (WiFiClient*)&secure : &plain; }
+};
+
+// --- HTTP-Download in eine Datei, schrittweise aus loop() ---
+// step() arbeitet höchstens budgetMs und kehrt zurück, sobald keine Daten anliegen. Der Verbindungsaufbau
+// läuft in einer Task (FetchConnect), step() fragt währenddessen nur ab. Hängt er länger als
+// CONNECT_GIVEUP_MS (Connect + Handshake), gilt der Download als fehlgeschlagen.
+// HTTP/1.0 ohne Keep-Alive: keine Chunked-Antworten, das Ende des Bodys ist das Ende der Verbindung.
+class HttpFetch {
+public:
+    enum State : uint8_t { FETCH_IDLE, FETCH_CONNECT, FETCH_CONNECTING, FETCH_HEADERS, FETCH_BODY, FETCH_DONE, FETCH_FAILED };
+
+    static const uint32_t CONNECT_TIMEOUT_MS = 4000;
+    static const uint32_t HANDSHAKE_TIMEOUT_S = 8;   // Ohne Vorgabe wartet WiFiClientSecure bis zu 120 s
+    static const uint32_t CONNECT_GIVEUP_MS = CONNECT_TIMEOUT_MS + HANDSHAKE_TIMEOUT_S * 1000 + 2000;
+    static const uint32_t CONNECT_TASK_STACK = 8192; // mbedTLS-Handshake
+    static const uint32_t STALL_TIMEOUT_MS = 5000;   // So lange ohne neue Daten, dann Abbruch
+    static const size_t MAX_BODY = 256 * 1024;       // LaMetric-Icons sind wenige KB groß
+    static const int MAX_REDIRECTS = 3;
+
+private:
+    FetchConnect* pending = nullptr;   // Laufender oder fertiger Verbindungsaufbau, besitzt den Client
+    WiFiClient* client = nullptr;
+    uint32_t connectStart = 0;
+    File out;
+    String url;
+    String outPath;
+    String line;          // Aktuelle Header-Zeile
+    String location;
+    State state = FETCH_IDLE;
+    int httpCode = 0;     // HTTP-Status oder HTTPC_ERROR_* (< 0)
+    int redirects = 0;
+    bool statusLine = true;
+    int32_t contentLength = -1;
+    size_t received = 0;
+    uint32_t lastActivity = 0;
+
+    // "http(s)://host[:port]/pfad"
+    static bool splitUrl(const String& u, String& host, uint16_t& port, String& path, bool& tls) {
+        int start;
+        if (u.startsWith("https://")) { tls = true; port = 443; start = 8; }
+        else if (u.startsWith("http://")) { tls = false; port = 80; start = 7; }
+        else return false;
+        int slash = u.indexOf('/', start);
+        host = slash < 0 ? u.substring(start) : u.substring(start, slash);
+        path = slash < 0 ? String("/") : u.substring(slash);
+        int colon = host.indexOf(':');
+        if (colon >= 0) {
+            port = host.substring(colon + 1).toInt();
+            host = host.substring(0, colon);
+        }
+        return host.length() > 0 && port > 0;
+    }
+
+    void fail(int code) {
+        httpCode = code;
+        finish();
+        state = FETCH_FAILED;
+        LittleFS.remove(outPath);
+    }
+
+    void finish() {
+        if (out) out.close();
+        if (client) client->stop();
+        client = nullptr;
+        dropConnect();
+    }
+
+    // Läuft die Task noch, übernimmt sie das Aufräumen, sonst wird hier gelöscht
+    void dropConnect() {
+        if (!pending) return;
+        int expected = FetchConnect::RUNNING;
+        if (!pending->state.compare_exchange_strong(expected, FetchConnect::ABANDONED)) delete pending;
+        pending = nullptr;
+    }
+
+    static void connectTask(void* arg) {
+        FetchConnect* job = (FetchConnect*)arg;
+        // connect() mit Timeout ist in WiFiClient nicht virtuell, daher über den konkreten Typ
+        if (job->tls) {
+            job->secure.setInsecure();
+            job->secure.setHandshakeTimeout(HANDSHAKE_TIMEOUT_S);
+            job->ok = job->secure.connect(job->host.c_str(), job->port, CONNECT_TIMEOUT_MS);
+        } else {
+            job->ok = job->plain.connect(job->host.c_str(), job->port, CONNECT_TIMEOUT_MS);
+        }
+        if (job->ok) job->ok = job->client()->print(job->request) == job->request.length();
+
+        int expected = FetchConnect::RUNNING;
+        if (!job->state.compare_exchange_strong(expected, FetchConnect::DONE)) delete job;   // loop() hat aufgegeben
+        vTaskDelete(nullptr);
+    }
+
+    bool stalled() { return millis() - lastActivity > STALL_TIMEOUT_MS; }
+
+    void connect() {
+        FetchConnect* job = new FetchConnect();
+        String path;
+        if (!splitUrl(url, job->host, job->port, path, job->tls)) { delete job; fail(HTTPC_ERROR_CONNECTION_REFUSED); return; }
+        job->request = "GET " + path + " HTTP/1.0\r\nHost: " + job->host +
+                       "\r\nUser-Agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36"
+                       "\r\nConnection: close\r\n\r\n";
+
+        // Kern 0 neben dem WiFi-Stack, loop() läuft auf Kern 1
+        if (xTaskCreatePinnedToCore(connectTask, "icon_connect", CONNECT_TASK_STACK, job, 1, nullptr, 0) != pdPASS) {
+            delete job;
+            fail(HTTPC_ERROR_CONNECTION_REFUSED);
+            return;
+        }
+        pending = job;
+        connectStart = millis();
+        state = FETCH_CONNECTING;
+    }
+
+    // Fertigen Client aus der Task übernehmen
+    void connected() {
+        if (!pending->ok) { fail(HTTPC_ERROR_CONNECTION_REFUSED); return; }
+        client = pending->client();
+        line = ""; location = "";
+        statusLine = true;
+        contentLength = -1;
+        httpCode = 0;
+        lastActivity = millis();
+        state = FETCH_HEADERS;
+    }
+
+    // Eine vollständige Header-Zeile auswerten. False = Header zu Ende.
+    bool headerLine() {
+        if (statusLine) {
+            statusLine = false;
+            int sp = line.indexOf(' ');
+            httpCode = sp > 0 ? line.substring(sp + 1).toInt() : 0;
+            return true;
+        }
+        if (line.length() == 0) return false;
+        int colon = line.indexOf(':');
+        if (colon <= 0) return true;
+        String key = line.substring(0, colon);
+        key.toLowerCase();
+        String value = line.substring(colon + 1);
+        value.trim();
+        if (key == "content-length") contentLength = value.toInt();
+        else if (key == "location") location = value;
+        return true;
+    }
+
+    void headersDone() {
+        if (httpCode == HTTP_CODE_OK) {
+            out = LittleFS.open(outPath, "w");
+            if (!out) { fail(HTTP_CODE_OK); return; }
+            received = 0;
+            state = FETCH_BODY;
+            return;
+        }
+        if ((httpCode == 301 || httpCode == 302 || httpCode == 307 || httpCode == 308) && location.length() && redirects < MAX_REDIRECTS) {
+            if (location.startsWith("/")) {
+                int slash = url.indexOf('/', url.indexOf("//") + 2);
+                location = (slash < 0 ? url : url.substring(0, slash)) + location;
+            }
+            Serial.println("[ICON] Redirect: " + location);
+            finish();
+            url = location;
+            redirects++;
+            state = FETCH_CONNECT;
+            return;
+        }
+        Serial.printf("[ICON] HTTP Error %d for %s\n", httpCode, url.c_str());
+        fail(httpCode ? httpCode : HTTPC_ERROR_NO_HTTP_SERVER);
+    }
+
+public:
+    ~HttpFetch() { cancel(); }
+
+    void start(const String& u, const String& path) {
+        cancel();
+        url = u;
+        outPath = path;
+        redirects = 0;
+        httpCode = 0;
+        received = 0;
+        state = FETCH_CONNECT;
+    }
+
+    void cancel() {
+        if (state != FETCH_IDLE && state != FETCH_DONE && state != FETCH_FAILED) LittleFS.remove(outPath);
+        finish();
+        state = FETCH_IDLE;
+    }
+
+    // Arbeitet bis zu budgetMs. Rückgabe: aktueller Zustand (FETCH_DONE / FETCH_FAILED = fertig).
+    State step(uint32_t budgetMs) {
+        uint32_t t0 = millis();
+        if (state == FETCH_CONNECT) connect();
+        if (state == FETCH_CONNECTING) {
+            if (pending->state.load() == FetchConnect::DONE) connected();
+            else if (millis() - connectStart > CONNECT_GIVEUP_MS) fail(HTTPC_ERROR_CONNECTION_REFUSED);
+            if (state != FETCH_HEADERS) return state;
+        }
+
+        while (state == FETCH_HEADERS && millis() - t0 < budgetMs) {
+            if (!client->available()) {
+                if (!client->connected()) fail(HTTPC_ERROR_CONNECTION_LOST);
+                else if (stalled()) fail(HTTPC_ERROR_READ_TIMEOUT);
+                return state;
+            }
+            lastActivity = millis();
+            while (state == FETCH_HEADERS && client->available()) {
+                char c = client->read();
+                if (c == '\r') continue;
+                if (c != '\n') {
+                    if (line.length() < 512) line += c;
+                    continue;
+                }
+                bool more = headerLine();
+                line = "";
+                if (!more) headersDone();
+            }
+        }
+
+        uint8_t buf[512];
+        while (state == FETCH_BODY && millis() - t0 < budgetMs) {
+            int avail = client->available();
+            if (avail <= 0) {
+                // Verbindung zu: fertig, sofern die angekündigte Länge erreicht ist
+                if (!client->connected()) {
+                    if (contentLength >= 0 && received < (size_t)contentLength) fail(HTTPC_ERROR_CONNECTION_LOST);
+                    else { finish(); state = received ? FETCH_DONE : FETCH_FAILED; }
+                }
+                else if (stalled()) fail(HTTPC_ERROR_READ_TIMEOUT);
+                return state;
+            }
+            int n = client->read(buf, min(avail, (int)sizeof(buf)));
+            if (n <= 0) break;
+            if (out.write(buf, n) != (size_t)n || received + n > MAX_BODY) { fail(HTTP_CODE_OK); return state; }
+            received += n;
+            lastActivity = millis();
+            if (contentLength >= 0 && received >= (size_t)contentLength) { finish(); state = FETCH_DONE; }
+        }
+        return state;
+    }
+
+    bool busy() const { return state == FETCH_CONNECT || state == FETCH_CONNECTING || state == FETCH_HEADERS || state == FETCH_BODY; }
+    State getState() const { return state; }
+    int getHttpCode() const { return httpCode; }
+    size_t getReceived() const { return received; }
+};
@@ -2,13 +2,14 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
-#include <list>
 #include <vector>
+#include <deque>
 #include <HTTPClient.h> 
 #include <WiFiClientSecure.h> 
 #include <PNGdec.h>     
 #include <AnimatedGIF.h> 
 #include "DisplayManager.h"
+#include "DecodeArena.h"
 #include <esp_heap_caps.h> 
 #include <new> // <--- WICHTIG: Erforderlich für "placement new" im PSRAM
 
@@ -22,6 +23,12 @@ struct SpiRamAllocator {
 using SpiRamJsonDocument = BasicJsonDocument<SpiRamAllocator>;
 #endif
 
+#include "IconCatalog.h"
+#include "IconCache.h"
+#include "TilePack.h"
+#include "AnimPack.h"
+#include "IconFetch.h"
+
 struct SheetDef { 
     String filePath; 
     int cols; 
@@ -33,23 +40,61 @@ struct SheetDef {
 struct CachedIcon { 
     String name; 
     uint16_t* pixels; 
-    uint8_t* alpha; 
+    uint8_t* alpha;   // Nur während des Ladens (Decode-Arena), danach durch 'runs' ersetzt
+    uint8_t* runs;    // Deckende Läufe pro Zeile (siehe DisplayManager::buildRunMask)
+    uint16_t* pixels2x; // Fertig skalierte 16x16 Variante (nur bei 8x8 LaMetric Icons)
+    uint8_t* runs2x;
+    size_t bytes;     // Belegter PSRAM inkl. skalierter Variante
     unsigned long lastUsed; 
     int width; 
     int height; 
+    bool packed;      // Aus einem Tile-Pack: 'runs' liegt im selben Block wie 'pixels'
+    bool prefetched;  // Vorgeladen und seitdem nicht abgerufen (Prefetch-Statistik)
+};
+
+// Frame einer geladenen Animation: Verweise in AnimatedIcon::runs bzw. ::data
+struct AnimFrameRef {
+    uint32_t runs;        // Offset der Run-Maske in 'runs'
+    uint32_t delta;       // Offset des Pixel-Deltas in 'data'
+    uint32_t deltaBytes;
+    uint16_t delayMs;
 };
 
+// Animation im Pack-Format (siehe AnimPack.h): Masken und Pixel-Deltas aller Frames liegen so im
+// Speicher wie im Flash, dekodiert wird nur der gerade gezeigte Frame (IconManager::animFrame).
 struct AnimatedIcon {
     String name;
-    uint16_t* pixels; 
-    uint8_t* alpha;   
-    uint16_t* delays; 
-    int width;        
-    int height;       
-    int totalHeight;  
-    int frameCount;   
-    int totalTime;    
+    uint8_t* data;        // Frame-Datensätze des Packs (ein Block), nullptr = fester Frame in 'pixels' (Platzhalter)
+    uint8_t* runs;        // Run-Masken aller Frames: zeigt in 'data', bei 8x8 auf die vergrößerte Kopie
+    AnimFrameRef* frames;
+    uint16_t* pixels;     // Frame-Puffer in Quellgröße, Ziel der Deltas
+    uint16_t* pixels2x;   // Vergrößerter Frame (nur 8x8 Animationen)
+    int decoded;          // Frame in 'pixels', -1 = keiner
+    size_t bytes;         // Belegter PSRAM: Block, Masken-Kopie, Frame-Tabelle und Puffer
+    int width;            // Anzeigemaße, 8x8 Animationen erscheinen als 16x16
+    int height;
+    int frameCount;
+    int totalTime;
     unsigned long lastUsed;
+    bool prefetched;      // Vorgeladen und seitdem nicht abgerufen (Prefetch-Statistik)
+};
+
+// Animation ausgepackt (alle Frames als RGB565 + Alpha), nur als Eingabe für den AnimPackWriter.
+// Die Puffer liegen in der Decode-Arena und gelten, solange der Scope offen ist.
+struct AnimFrames {
+    uint16_t* pixels = nullptr;
+    uint8_t* alpha = nullptr;
+    uint16_t* delays = nullptr;
+    int width = 0, height = 0, frameCount = 0;
+
+    bool alloc(DecodeScope& job, int w, int h, int frames) {
+        width = w; height = h; frameCount = frames;
+        size_t n = (size_t)w * h * frames;
+        pixels = job.alloc<uint16_t>(n, true);
+        alpha = job.alloc<uint8_t>(n, true);
+        delays = job.alloc<uint16_t>(frames);
+        return pixels && alpha && delays;
+    }
 };
 
 struct GifConvertContext {
@@ -76,6 +121,19 @@ struct PngAnimContext {
         uint32_t transColor; 
 };
 
+// Streifenweise Umwandlung eines Sheets in ein Tile-Pack: eine Kachelzeile (Sheet-Breite x tileH)
+struct TileBandContext {
+    TilePackWriter* writer;
+    uint16_t* pixels;
+    uint8_t* alpha;
+    uint16_t* tilePixels;
+    uint8_t* tileAlpha;
+    int tileW, tileH, cols, rows;
+    bool hasTransColor;
+    uint32_t transColor;
+    bool ok;
+};
+
 struct PngDownloadContext {
     File* fOut;
     int w;
@@ -84,14 +142,84 @@ struct PngDownloadContext {
     uint32_t transColor;
 };
 
+// GIF -> Animations-Pack, Frame für Frame: der Decoder liest aus der Datei, jeder fertige Frame wird
+// sofort als Delta angehängt. Im Speicher liegen nur Canvas, ein RGB565-Frame und der Vorgänger im
+// Writer, unabhängig von der Frame-Anzahl.
+struct GifStream {
+    AnimPackWriter writer;  // Schreibt nach outPath + ".tmp", erst finishGif() benennt um
+    String outPath;
+    uint8_t* canvas = nullptr;
+    uint16_t* framePixels = nullptr;
+    uint8_t* frameAlpha = nullptr;
+    DecodeScope scratch;    // Canvas, Frame-Puffer und Writer-Puffer, bis releaseGif()
+    GifConvertContext ctx = {};
+    int frames = 0, frame = 0, prevDispose = 2;
+    bool open = false;    // AnimatedGIF hält die Quelldatei
+};
+
+// Vorgemerktes Icon (IconManager::prefetchText), wird in freier Zeit geladen
+struct IconPrefetch {
+    String name;          // Ohne Präfix; bei alias der Alias-Name aus dem Katalog
+    bool anim;
+    bool alias;           // {lt:}: erst beim Laden auflösen, der Katalog wird im Netzwerk-Pfad nicht angefasst
+};
+
+// Ausstehender LaMetric-Download, wird von IconManager::processFetches() in Zeitscheiben abgearbeitet
+struct IconFetchJob {
+    enum Stage : uint8_t { QUEUED, DOWNLOAD, CONVERT };
+
+    String id;
+    uint32_t hash;
+    bool anim;
+    Stage stage = QUEUED;
+    GifStream gif;        // Umwandlung über mehrere Zeitscheiben
+
+    IconFetchJob(const String& id, uint32_t hash, bool anim) : id(id), hash(hash), anim(anim) {}
+};
+
 class IconManager {
 private:
-    std::list<CachedIcon*> iconCache;      
-    std::list<AnimatedIcon*> animCache;    
-    std::vector<String> failedIcons;       
-
-    const size_t MAX_CACHE_SIZE_STATIC = 20;
-    const size_t MAX_CACHE_SIZE_ANIM = 10; 
+    IconCache<CachedIcon> iconCache;
+    IconCache<AnimatedIcon> animCache;
+    IconMissCache misses;                  // Fehlgeschlagene Lookups mit Ablaufzeit
+    TilePackReader tilePack;               // Zuletzt benutztes Tile-Pack, bleibt geöffnet
+    String tilePackFailed;                 // Pack, dessen Erzeugung fehlschlug (nicht bei jedem Icon neu versuchen)
+    int lastHttpCode = 0;                  // Letzter Download: HTTP-Code oder HTTPC_ERROR_* (< 0)
+
+    // Downloads laufen im Hintergrund: ein fehlendes LaMetric-Icon wird eingereiht und solange durch
+    // einen Platzhalter (ICON_PENDING) ersetzt. Jede Änderung erhöht iconGeneration, damit vorgerenderte
+    // Inhalte (ScrollStrip) neu aufgebaut werden.
+    static const size_t MAX_FETCHES = 8;
+    std::deque<IconFetchJob> fetchQueue;
+    HttpFetch http;
+    String iconBaseUrl = "https://developer.lametric.com/content/apps/icon_thumbs/";
+    uint32_t iconGeneration = 0;
+    CachedIcon pendingIcon{};              // Platzhalter, nie im Cache, nie freigegeben
+    AnimatedIcon pendingAnim{};            // Ein Frame, teilt sich Pixel und Maske mit pendingIcon
+    AnimFrameRef pendingFrame = {0, 0, 0, 1000};
+
+    // Icons aus eingehenden MQTT-Seiten und Overlays werden vorgemerkt und in freier Zeit geladen,
+    // damit der erste Frame, der sie zeigt, weder Sheet dekodieren noch Download anstoßen muss
+    static const size_t MAX_PREFETCH = 32;
+    std::deque<IconPrefetch> prefetchQueue;
+    uint32_t prefetchQueued = 0;           // Vorgemerkt (ohne bereits geladene)
+    uint32_t prefetchLoaded = 0;           // Vom Prefetch in den Cache geladen
+    uint32_t prefetchHits = 0;             // Beim ersten Abruf schon da
+    uint32_t prefetchLate = 0;             // Abgerufen, bevor der Prefetch dran war
+    uint32_t prefetchWasted = 0;           // Verdrängt, ohne je abgerufen zu werden
+
+    // Arbeitsspeicher aller Lade- und Umwandlungsaufträge (config.json: system.decode_arena_kb),
+    // wird in begin() einmal reserviert
+    DecodeArena arena;
+    size_t arenaSize = 128 * 1024;
+
+    // Gemeinsames PSRAM-Budget beider Caches (config.json: system.icon_cache_kb).
+    // Verdrängt wird jeweils der älteste Eintrag aus beiden Caches.
+    size_t cacheBudget = 512 * 1024;
+
+    // Index über /catalog.json, wird nur nach invalidateCatalog() neu aufgebaut
+    IconCatalog catalog;
+    bool catalogDirty = true;
     
     // --- DIE OPTIMIERUNG ---
     // Keine direkten Instanzen mehr, sondern Zeiger für den PSRAM!
@@ -130,14 +258,442 @@ private:
         return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
     }
 
+    // --- 2x Vorskalierung (LaMetric 8x8 -> 16x16), einmalig beim Einfügen in den Cache ---
+    static void scaleInto2x(uint16_t* dst, const uint16_t* src, int w, int h) {
+        int dw = w * 2;
+        for (int y = 0; y < h; y++) {
+            uint16_t* row = dst + (y * 2) * dw;
+            for (int x = 0; x < w; x++) row[x * 2] = row[x * 2 + 1] = src[y * w + x];
+            memcpy(row + dw, row, dw * sizeof(uint16_t));
+        }
+    }
+
+    uint16_t* scalePixels2x(const uint16_t* src, int w, int h) {
+        uint16_t* dst = (uint16_t*)heap_caps_malloc(w * h * 4 * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (dst) scaleInto2x(dst, src, w, h);
+        return dst;
+    }
+
+    // Jede Zeile doppelt, Startspalte und Länge verdoppelt (Quellbreite max. 127). Rückgabe: Ende in dst.
+    static uint8_t* scaleRunsInto2x(uint8_t* dst, const uint8_t* runs, int h) {
+        for (int y = 0; y < h; y++) {
+            size_t rowLen = 1 + 2 * runs[0];
+            uint8_t* row = dst;
+            *dst++ = runs[0];
+            for (size_t i = 1; i < rowLen; i++) *dst++ = runs[i] * 2;
+            memcpy(dst, row, rowLen); dst += rowLen;
+            runs += rowLen;
+        }
+        return dst;
+    }
+
+    uint8_t* scaleRuns2x(const uint8_t* runs, int h, size_t size) {
+        uint8_t* dst = (uint8_t*)heap_caps_malloc(size * 2, MALLOC_CAP_SPIRAM);
+        if (dst) scaleRunsInto2x(dst, runs, h);
+        return dst;
+    }
+
+    // Ersetzt den Alpha-Kanal durch die Run-Maske für den Blitter und legt bei 8x8 Icons die
+    // 16x16 Variante an. False = kein Speicher.
+    bool prepareRuns(CachedIcon* icon) {
+        size_t runSize = 0;
+        if (icon->runs) {
+            // Tile-Pack: Maske liegt schon vor
+            runSize = DisplayManager::skipRunRows(icon->runs, icon->height) - icon->runs;
+        } else {
+            icon->runs = DisplayManager::buildRunMask(icon->alpha, icon->width, icon->height, 10, &runSize);
+            icon->alpha = nullptr;    // Gehört der Arena
+            if (!icon->runs) return false;
+        }
+        icon->bytes = icon->width * icon->height * sizeof(uint16_t) + runSize;
+
+        if (icon->width == 8 && icon->height == 8) {
+            icon->pixels2x = scalePixels2x(icon->pixels, 8, 8);
+            icon->runs2x = scaleRuns2x(icon->runs, 8, runSize);
+            if (!icon->pixels2x || !icon->runs2x) return false;
+            icon->bytes += 16 * 16 * sizeof(uint16_t) + runSize * 2;
+        }
+        return true;
+    }
+
+    void freeIcon(CachedIcon* icon) {
+        if(icon->pixels) heap_caps_free(icon->pixels); 
+        if(icon->runs && !icon->packed) heap_caps_free(icon->runs);
+        if(icon->pixels2x) heap_caps_free(icon->pixels2x);
+        if(icon->runs2x) heap_caps_free(icon->runs2x);
+        delete icon;
+    }
+
+    // Schafft Platz für 'need' Bytes. Der gerade geladene Eintrag zählt nicht mit, er wird auch
+    // dann aufgenommen, wenn er allein das Budget übersteigt (sonst würde er bei jedem Frame neu geladen).
+    void makeRoom(size_t need, bool forAnim) {
+        unsigned long now = millis();
+        while (iconCache.getBytes() + animCache.getBytes() + need > cacheBudget || (forAnim ? animCache.full() : iconCache.full())) {
+            bool haveIcon = !iconCache.empty(), haveAnim = !animCache.empty();
+            if (!haveIcon && !haveAnim) break;
+            bool evictAnim;
+            if (forAnim && animCache.full()) evictAnim = true;
+            else if (!forAnim && iconCache.full()) evictAnim = false;
+            else if (!haveIcon) evictAnim = true;
+            else if (!haveAnim) evictAnim = false;
+            else evictAnim = (now - animCache.oldestUse()) >= (now - iconCache.oldestUse());
+            if (evictAnim) {
+                AnimatedIcon* anim = animCache.popLRU();
+                if (anim->prefetched) prefetchWasted++;
+                freeAnim(anim);
+            } else {
+                CachedIcon* icon = iconCache.popLRU();
+                if (icon->prefetched) prefetchWasted++;
+                freeIcon(icon);
+            }
+        }
+    }
+
+    SheetDef sheetDef(const CatalogSheet& sheet) const {
+        SheetDef def;
+        def.filePath = catalog.str(sheet.file);
+        def.cols = sheet.cols;
+        return def;
+    }
+
+    static bool isNumericId(const String& id) {
+        if (id.length() == 0) return false;
+        for (unsigned int i = 0; i < id.length(); i++) if (!isDigit(id[i])) return false;
+        return true;
+    }
+
+    // Ordnet einen fehlgeschlagenen Download ein: ohne Verbindung oder bei Serverfehlern später erneut versuchen
+    IconMiss downloadMiss() const {
+        if (lastHttpCode < 0 || lastHttpCode >= 500 || lastHttpCode == 429) return MISS_NETWORK;
+        if (lastHttpCode == HTTP_CODE_OK) return MISS_DECODE;
+        return MISS_NOT_FOUND;
+    }
+
+    void recordMiss(const String& name, uint32_t hash, bool anim, IconMiss reason) {
+        uint32_t ttl = misses.record(hash, anim, reason);
+        if (reason == MISS_NETWORK) Serial.printf("[ICON] %s: Netzwerkfehler, nächster Versuch in %lu s\n", name.c_str(), (unsigned long)(ttl / 1000));
+    }
+
+    // Abgewiesen, weil die Decode-Arena gerade von einem anderen Auftrag belegt ist: nur kurz sperren.
+    // Passt der Auftrag auch in die leere Arena nicht, ist das ein Dekodierfehler wie jeder andere.
+    static IconMiss decodeMiss(const DecodeScope& job, IconMiss reason) {
+        if (reason != MISS_DECODE || !job.rejected()) return reason;
+        return job.oversize() ? MISS_DECODE : MISS_BUSY;
+    }
+
+    // Lädt ein statisches Icon (Katalog, /icons/ oder Download) und nimmt es in den Cache auf
+    IconHandle loadIcon(const String& name, uint32_t hash) {
+        if (misses.blocked(hash, false)) return 0;
+
+        CachedIcon* newIcon = nullptr;
+        bool foundInCatalog = false;
+        IconMiss reason = MISS_DECODE;
+        DecodeScope job(arena);
+
+        ensureCatalog();
+        const CatalogSheet* sheet;
+        uint16_t sheetIndex;
+        if (catalog.findIcon(name.c_str(), sheet, sheetIndex)) {
+            foundInCatalog = true;
+            newIcon = loadIconFromSheet(sheetDef(*sheet), sheetIndex, job);
+        }
+
+        if (!foundInCatalog) {
+             if (fetchPending(hash, false)) return ICON_PENDING;
+             if (LittleFS.exists("/icons/" + name + ".bmp")) {
+                  newIcon = loadBmpFile("/icons/" + name + ".bmp", job);
+             } else if (isNumericId(name)) {
+                  return queueFetch(name, hash, false);
+             } else reason = MISS_NOT_FOUND;
+        }
+        
+        if (newIcon && !prepareRuns(newIcon)) { freeIcon(newIcon); newIcon = nullptr; }
+        if (!newIcon) { recordMiss(name, hash, false, decodeMiss(job, reason)); return 0; }
+
+        misses.forget(hash, false);
+        newIcon->name = name; 
+        makeRoom(newIcon->bytes, false);
+        return iconCache.insert(newIcon, hash);
+    }
+
+    IconHandle loadAnim(const String& id, uint32_t hash) {
+        if (misses.blocked(hash, true)) return 0;
+
+        AnimatedIcon* anim = nullptr;
+        bool foundInCatalog = false;
+        IconMiss reason = MISS_DECODE;
+        DecodeScope job(arena);
+
+        ensureCatalog();
+        if (const CatalogAnim* spec = catalog.findAnim(id.c_str())) {
+            foundInCatalog = true;
+            anim = loadCatalogAnim(*spec, job);
+        }
+
+        if (!foundInCatalog) {
+            if (fetchPending(hash, true)) return ICON_PENDING;
+            String path = "/iconsan/" + id + ".ani";
+            if (LittleFS.exists(path)) anim = loadAnimPack(path);
+            else if (LittleFS.exists("/iconsan/" + id + ".bmp")) anim = migrateAnimBmp(id, job);
+            else if (isNumericId(id)) return queueFetch(id, hash, true);
+            else reason = MISS_NOT_FOUND;
+        }
+        
+        if (!anim) { recordMiss(id, hash, true, decodeMiss(job, reason)); return 0; }
+        misses.forget(hash, true);
+
+        anim->name = id;
+        makeRoom(anim->bytes, true);
+        return animCache.insert(anim, hash);
+    }
+
+    // Entfernt einen noch nicht bearbeiteten Prefetch. True = war vorgemerkt (kam zu spät).
+    bool dropPrefetch(const String& name, bool anim) {
+        for (auto it = prefetchQueue.begin(); it != prefetchQueue.end(); ++it) {
+            if (!it->alias && it->anim == anim && it->name == name) { prefetchQueue.erase(it); return true; }
+        }
+        return false;
+    }
+
+    void queuePrefetch(const String& name, bool anim, bool alias) {
+        if (name.length() == 0 || prefetchQueue.size() >= MAX_PREFETCH) return;
+        if (!alias && (anim ? animCache.contains(name.c_str(), iconNameHash(name.c_str()))
+                            : iconCache.contains(name.c_str(), iconNameHash(name.c_str())))) return;
+        for (const IconPrefetch& p : prefetchQueue) if (p.anim == anim && p.alias == alias && p.name == name) return;
+        prefetchQueue.push_back({name, anim, alias});
+        prefetchQueued++;
+    }
+
+    // Lädt ein vorgemerktes Icon am Namens-Cache vorbei (zählt nicht als Treffer oder Fehlgriff).
+    // Fehlt es lokal, stößt das den Download an (ICON_PENDING, kein Cache-Eintrag).
+    void prefetchOne(const String& name, bool anim) {
+        uint32_t hash = iconNameHash(name.c_str());
+        if (anim) {
+            if (animCache.contains(name.c_str(), hash)) return;
+            AnimatedIcon* item = animCache.item(loadAnim(name, hash));
+            if (item) { item->prefetched = true; prefetchLoaded++; }
+        } else {
+            if (iconCache.contains(name.c_str(), hash)) return;
+            CachedIcon* item = iconCache.item(loadIcon(name, hash));
+            if (item) { item->prefetched = true; prefetchLoaded++; }
+        }
+    }
+
+    bool fetchPending(uint32_t hash, bool anim) const {
+        for (const IconFetchJob& job : fetchQueue) if (job.hash == hash && job.anim == anim) return true;
+        return false;
+    }
+
+    // Reiht einen Download ein. Ist die Warteschlange voll, bleibt es beim Platzhalter und der
+    // nächste Zugriff versucht es erneut.
+    IconHandle queueFetch(const String& id, uint32_t hash, bool anim) {
+        if (fetchQueue.size() < MAX_FETCHES) fetchQueue.emplace_back(id, hash, anim);
+        return ICON_PENDING;
+    }
+
+    CachedIcon* placeholderIcon() { return pendingIcon.pixels ? &pendingIcon : nullptr; }
+    AnimatedIcon* placeholderAnim() { return pendingAnim.pixels ? &pendingAnim : nullptr; }
+
+    // Wie IconCache::item(), ICON_PENDING liefert den Platzhalter
+    CachedIcon* iconItem(IconHandle h) { return h == ICON_PENDING ? placeholderIcon() : iconCache.item(h); }
+    AnimatedIcon* animItem(IconHandle h) { return h == ICON_PENDING ? placeholderAnim() : animCache.item(h); }
+
+    // Gedimmter, abgerundeter 16x16 Rahmen als Platzhalter für Icons, die noch geladen werden
+    void buildPlaceholders() {
+        const int S = 16;
+        DecodeScope job(arena);
+        uint16_t* pixels = (uint16_t*)heap_caps_malloc(S * S * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        uint8_t* alpha = job.alloc<uint8_t>(S * S);
+        if (!pixels || !alpha) {
+            if (pixels) heap_caps_free(pixels);
+            return;
+        }
+        for (int y = 0; y < S; y++) {
+            for (int x = 0; x < S; x++) {
+                bool edge = (y == 0 || y == S - 1) ? (x > 0 && x < S - 1) : (x == 0 || x == S - 1);
+                pixels[y * S + x] = 0x39E7;
+                alpha[y * S + x] = edge ? 255 : 0;
+            }
+        }
+        pendingIcon.pixels = pixels;
+        pendingIcon.alpha = alpha;
+        pendingIcon.width = S; pendingIcon.height = S;
+        if (!prepareRuns(&pendingIcon)) {
+            heap_caps_free(pixels);
+            pendingIcon.pixels = nullptr;
+            return;
+        }
+
+        pendingAnim.pixels = pendingIcon.pixels;
+        pendingAnim.runs = pendingIcon.runs;
+        pendingAnim.frames = &pendingFrame;
+        pendingAnim.width = S; pendingAnim.height = S;
+        pendingAnim.frameCount = 1;
+    }
+
+    static bool hasPrefix(const String& name) {
+        return name.length() > 3 && name[2] == ':' &&
+               (name.startsWith("ln:") || name.startsWith("la:") || name.startsWith("ic:") || name.startsWith("an:"));
+    }
+
+    void freeAnim(AnimatedIcon* anim) {
+        if(anim->data) heap_caps_free(anim->data);
+        if(anim->runs && anim->runs != anim->data) heap_caps_free(anim->runs);
+        if(anim->frames) heap_caps_free(anim->frames);
+        if(anim->pixels) heap_caps_free(anim->pixels);
+        if(anim->pixels2x) heap_caps_free(anim->pixels2x);
+        delete anim;
+    }
+
+    // --- Animations-Packs ---
+    // Baut aus den Frame-Datensätzen eines Packs eine Animation. Übernimmt 'data' (auch bei Fehlern).
+    AnimatedIcon* animFromPack(const AnimPackHeader& h, uint8_t* data, size_t size) {
+        AnimatedIcon* anim = new AnimatedIcon();
+        anim->data = data;
+        anim->decoded = -1;
+        anim->frameCount = h.frameCount;
+        anim->lastUsed = millis();
+        size_t n = (size_t)h.width * h.height;
+        anim->frames = (AnimFrameRef*)heap_caps_malloc(h.frameCount * sizeof(AnimFrameRef), MALLOC_CAP_SPIRAM);
+        anim->pixels = (uint16_t*)heap_caps_malloc(n * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!data || !anim->frames || !anim->pixels) { freeAnim(anim); return nullptr; }
+
+        // Datensätze sind nicht ausgerichtet: Köpfe per memcpy
+        size_t pos = 0, runBytes = 0;
+        for (int i = 0; i < h.frameCount; i++) {
+            AnimFrameHeader fh;
+            if (pos + sizeof(fh) > size) { freeAnim(anim); return nullptr; }
+            memcpy(&fh, data + pos, sizeof(fh));
+            pos += sizeof(fh);
+            if (pos + fh.runBytes + fh.deltaBytes > size) { freeAnim(anim); return nullptr; }
+            anim->frames[i] = { (uint32_t)pos, (uint32_t)(pos + fh.runBytes), fh.deltaBytes, fh.delayMs };
+            anim->totalTime += fh.delayMs;
+            runBytes += fh.runBytes;
+            pos += fh.runBytes + fh.deltaBytes;
+        }
+        anim->runs = data;
+        anim->width = h.width; anim->height = h.height;
+        anim->bytes = size + h.frameCount * sizeof(AnimFrameRef) + n * sizeof(uint16_t);
+
+        // 8x8 Animationen werden immer vergrößert dargestellt: Masken einmal skalieren, Pixel pro Frame
+        if (h.width == 8 && h.height == 8) {
+            uint8_t* runs2x = (uint8_t*)heap_caps_malloc(runBytes * 2, MALLOC_CAP_SPIRAM);
+            anim->pixels2x = (uint16_t*)heap_caps_malloc(16 * 16 * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+            if (!runs2x || !anim->pixels2x) { if (runs2x) heap_caps_free(runs2x); freeAnim(anim); return nullptr; }
+            uint8_t* p = runs2x;
+            for (int i = 0; i < h.frameCount; i++) {
+                const uint8_t* src = data + anim->frames[i].runs;
+                anim->frames[i].runs = p - runs2x;
+                p = scaleRunsInto2x(p, src, 8);
+            }
+            anim->runs = runs2x;
+            anim->width = 16; anim->height = 16;
+            anim->bytes += runBytes * 2 + 16 * 16 * sizeof(uint16_t);
+        }
+        return anim;
+    }
+
+    AnimatedIcon* loadAnimPack(const String& packPath, uint32_t expectedSource = 0, uint32_t expectedParams = 0) {
+        AnimPackHeader h;
+        size_t size = 0;
+        uint8_t* data = readAnimPack(packPath, h, size, expectedSource, expectedParams);
+        return data ? animFromPack(h, data, size) : nullptr;
+    }
+
+    // Kodiert ausgepackte Frames nach packPath (leer = nur in den Speicher des Writers)
+    bool encodeAnim(const AnimFrames& src, AnimPackWriter& writer, const String& packPath, uint32_t sourceSize, uint32_t sourceParams) {
+        if (!writer.begin(packPath, src.width, src.height, src.frameCount, sourceSize, sourceParams)) return false;
+        size_t n = (size_t)src.width * src.height;
+        for (int i = 0; i < src.frameCount; i++) {
+            if (i % 8 == 7) yield();
+            if (!writer.addFrame(src.pixels + i * n, src.alpha + i * n, src.delays[i])) break;
+        }
+        return writer.finish();
+    }
+
+    // Legt das Pack an und lädt es. Passt es nicht mehr ins Flash (gleiche Reserve wie Tile-Packs),
+    // wird es nur im Speicher gebaut und beim nächsten Laden erneut versucht.
+    AnimatedIcon* animFromFrames(const AnimFrames& src, const String& packPath, uint32_t sourceSize, uint32_t sourceParams, DecodeScope& job) {
+        AnimPackWriter writer;
+        writer.setScratch(&job);
+        if (encodeAnim(src, writer, packPath, sourceSize, sourceParams)) {
+            if (LittleFS.totalBytes() - LittleFS.usedBytes() >= TILEPACK_FS_RESERVE) {
+                AnimatedIcon* anim = loadAnimPack(packPath);
+                if (anim) return anim;
+            }
+            LittleFS.remove(packPath);
+        }
+        if (!encodeAnim(src, writer, "", sourceSize, sourceParams)) return nullptr;
+        size_t size = 0;
+        uint8_t* data = writer.takeRecords(size);
+        return animFromPack(writer.getHeader(), data, size);
+    }
+
+    // Katalog-Animation: aus dem Pack neben dem Sheet (/clear-day.png -> /clear-day.ani), fehlt es
+    // oder passt es nicht mehr zu Sheet und Katalog-Angaben, wird es aus dem Sheet neu erzeugt.
+    // Ein Pack kann im Katalog auch direkt eingetragen werden.
+    AnimatedIcon* loadCatalogAnim(const CatalogAnim& spec, DecodeScope& job) {
+        String file = catalog.str(spec.file);
+        if (isAnimPack(file)) return loadAnimPack(file);
+
+        uint32_t sourceSize = fileSize(file);
+        if (!sourceSize) return nullptr;
+        String packPath = animPackPath(file);
+        uint32_t params = animPackParams(spec.frameW, spec.delayMs, spec.rotated);
+        AnimatedIcon* anim = loadAnimPack(packPath, sourceSize, params);
+        if (anim) return anim;
+
+        uint32_t t0 = millis();
+        AnimFrames src;
+        if (!readAnimSheet(file, spec.frameW, spec.delayMs, spec.rotated, src, job)) return nullptr;
+        anim = animFromFrames(src, packPath, sourceSize, params, job);
+        Serial.printf("[ICON] Anim-Pack %s: %s, %d Frames %dx%d, %lu ms\n", packPath.c_str(), anim ? "OK" : "FEHLER",
+                      src.frameCount, src.width, src.height, (unsigned long)(millis() - t0));
+        return anim;
+    }
+
+    // Ältere Downloads (/iconsan/ID.bmp + .dly) einmalig ins Pack-Format übernehmen
+    AnimatedIcon* migrateAnimBmp(const String& id, DecodeScope& job) {
+        String bmpPath = "/iconsan/" + id + ".bmp";
+        String packPath = "/iconsan/" + id + ".ani";
+        AnimFrames src;
+        if (!readAnimBmp(bmpPath, src, job)) return nullptr;
+        AnimatedIcon* anim = animFromFrames(src, packPath, 0, 0, job);
+        if (anim && LittleFS.exists(packPath)) {
+            LittleFS.remove(bmpPath);
+            LittleFS.remove("/iconsan/" + id + ".dly");
+        }
+        return anim;
+    }
+
+    // Stellt 'frame' im Frame-Puffer her: Deltas ab dem zuletzt dekodierten Frame anwenden, beim
+    // Zurückspringen (Ende der Schleife) ab einem schwarzen Frame von vorn
+    const uint16_t* animFrame(AnimatedIcon* anim, int frame) {
+        if (!anim->data || frame == anim->decoded) return anim->pixels2x ? anim->pixels2x : anim->pixels;
+        int w = anim->pixels2x ? anim->width / 2 : anim->width;
+        int h = anim->pixels2x ? anim->height / 2 : anim->height;
+        size_t n = (size_t)w * h;
+        if (frame < anim->decoded || anim->decoded < 0) {
+            memset(anim->pixels, 0, n * sizeof(uint16_t));
+            anim->decoded = -1;
+        }
+        while (anim->decoded < frame) {
+            const AnimFrameRef& f = anim->frames[++anim->decoded];
+            applyAnimDelta(anim->pixels, n, anim->data + f.delta, f.deltaBytes);
+        }
+        if (!anim->pixels2x) return anim->pixels;
+        scaleInto2x(anim->pixels2x, anim->pixels, w, h);
+        return anim->pixels2x;
+    }
+
     // --- Laderoutinen ---
-    AnimatedIcon* loadAnimFromFS(String filename, String name) {
-        if (!LittleFS.exists(filename)) return nullptr;
+    // Animations-BMP (Frames untereinander, 32 Bit) mit Delays aus der .dly daneben
+    bool readAnimBmp(const String& filename, AnimFrames& out, DecodeScope& job) {
         File f = LittleFS.open(filename, "r");
-        if (!f) return nullptr;
+        if (!f) return false;
 
         uint8_t header[54];
-        if (f.read(header, 54) != 54) { f.close(); return nullptr; }
+        if (f.read(header, 54) != 54) { f.close(); return false; }
         
         uint32_t dataOffset = read32(header, 10);
         int32_t w = read32(header, 18);
@@ -145,72 +701,41 @@ private:
         bool flipY = true;
         if (h < 0) { h = -h; flipY = false; } 
 
-        if (w <= 0 || h <= 0) { f.close(); return nullptr; }
+        if (w <= 0 || h <= 0) { f.close(); return false; }
 
         int frames = 1;
         int frameH = h;
         if (h > w && (h % w == 0)) { frames = h / w; frameH = w; }
         else if (h > 8 && w == 8) { frames = h / 8; frameH = 8; }
 
-        AnimatedIcon* anim = new AnimatedIcon();
-        anim->name = name; anim->width = w; anim->height = frameH;
-        anim->totalHeight = h; anim->frameCount = frames;
-        anim->lastUsed = millis();
-
-        size_t numPixels = w * h;
-        anim->pixels = (uint16_t*)heap_caps_malloc(numPixels * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-        anim->alpha = (uint8_t*)heap_caps_malloc(numPixels * sizeof(uint8_t), MALLOC_CAP_SPIRAM);
-        anim->delays = (uint16_t*)heap_caps_malloc(frames * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-
-        if (!anim->pixels || !anim->alpha || !anim->delays) { 
-            if(anim->pixels) heap_caps_free(anim->pixels); 
-            if(anim->alpha) heap_caps_free(anim->alpha); 
-            if(anim->delays) heap_caps_free(anim->delays);
-            delete anim; f.close(); return nullptr; 
-        }
+        size_t lineSize = w * 4;
+        uint8_t* lineBuffer = job.alloc<uint8_t>(lineSize);
+        if (!lineBuffer || !out.alloc(job, w, frameH, frames)) { f.close(); return false; }
 
         String dlyFilename = filename;
         dlyFilename.replace(".bmp", ".dly");
-        int calculatedTotalTime = 0;
-
         File fDly = LittleFS.open(dlyFilename, "r");
-        if (fDly) {
-            for (int i = 0; i < frames; i++) {
-                uint16_t d = 100;
-                if (fDly.available() >= 2) fDly.read((uint8_t*)&d, 2);
-                anim->delays[i] = d;
-                calculatedTotalTime += d;
-            }
-            fDly.close();
-        } else {
-            for (int i = 0; i < frames; i++) {
-                anim->delays[i] = 100;
-                calculatedTotalTime += 100;
-            }
-        }
-        anim->totalTime = calculatedTotalTime;
-
-        size_t lineSize = w * 4;
-        uint8_t* lineBuffer = (uint8_t*)heap_caps_malloc(lineSize, MALLOC_CAP_SPIRAM);
-        if (!lineBuffer) { 
-            heap_caps_free(anim->pixels); heap_caps_free(anim->alpha); heap_caps_free(anim->delays);
-            delete anim; f.close(); return nullptr; 
+        for (int i = 0; i < frames; i++) {
+            uint16_t d = 100;
+            if (fDly && fDly.available() >= 2) fDly.read((uint8_t*)&d, 2);
+            out.delays[i] = d;
         }
+        if (fDly) fDly.close();
 
-        for (int y = 0; y < h; y++) {
+        for (int y = 0; y < frameH * frames; y++) {
             int bmpRow = flipY ? (h - 1 - y) : y;
             f.seek(dataOffset + ((size_t)bmpRow * w * 4));
             f.read(lineBuffer, lineSize);
             for (int x = 0; x < w; x++) {
                 int idx = x * 4;
-                anim->pixels[y * w + x] = color565(lineBuffer[idx+2], lineBuffer[idx+1], lineBuffer[idx]);
-                anim->alpha[y * w + x] = lineBuffer[idx+3];
+                out.pixels[y * w + x] = color565(lineBuffer[idx+2], lineBuffer[idx+1], lineBuffer[idx]);
+                out.alpha[y * w + x] = lineBuffer[idx+3];
             }
         }
-        heap_caps_free(lineBuffer); f.close(); return anim;
+        f.close(); return true;
     }
 
-    CachedIcon* loadBmpFile(String filename) {
+    CachedIcon* loadBmpFile(String filename, DecodeScope& job) {
         if (!LittleFS.exists(filename)) return nullptr;
         File f = LittleFS.open(filename, "r");
         uint8_t header[54];
@@ -226,13 +751,11 @@ private:
         newIcon->width = width; newIcon->height = height;
         size_t numPixels = width * height;
         
-        newIcon->pixels = (uint16_t*)heap_caps_malloc(numPixels * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-        newIcon->alpha = (uint8_t*)heap_caps_malloc(numPixels * sizeof(uint8_t), MALLOC_CAP_SPIRAM);
-        if (!newIcon->pixels || !newIcon->alpha) { delete newIcon; f.close(); return nullptr; }
-
         size_t lineSize = width * 4;
-        uint8_t* lineBuffer = (uint8_t*)heap_caps_malloc(lineSize, MALLOC_CAP_SPIRAM);
-        if(!lineBuffer) { heap_caps_free(newIcon->pixels); heap_caps_free(newIcon->alpha); delete newIcon; f.close(); return nullptr; }
+        uint8_t* lineBuffer = job.alloc<uint8_t>(lineSize);
+        newIcon->alpha = job.alloc<uint8_t>(numPixels);
+        newIcon->pixels = (uint16_t*)heap_caps_malloc(numPixels * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        if (!newIcon->pixels || !newIcon->alpha || !lineBuffer) { freeIcon(newIcon); f.close(); return nullptr; }
 
         for (int y = 0; y < height; y++) {
             int bmpRow = flipY ? (height - 1 - y) : y;
@@ -244,7 +767,7 @@ private:
                 newIcon->alpha[y * width + x] = lineBuffer[idx+3];
             }
         }
-        heap_caps_free(lineBuffer); f.close(); return newIcon;
+        f.close(); return newIcon;
     }
 
     // --- DER HOCHEFFIZIENTE UND KUGELSICHERE DEKODER ---
@@ -381,16 +904,16 @@ private:
     }
 
     // --- 3. DIE SCHNELLE RAM-LADEFUNKTION ---
-    AnimatedIcon* loadAnimFromPngSheet(String name, String filename, int frameW, int delayMs, bool rotated = false) {
-        if (!LittleFS.exists(filename)) return nullptr;
-        if (!png) return nullptr; // Sicherheits-Check
+    // Zerlegt ein PNG-Sheet in Frames (Eingabe für das Animations-Pack)
+    bool readAnimSheet(const String& filename, int frameW, int delayMs, bool rotated, AnimFrames& out, DecodeScope& job) {
+        if (!png) return false; // Sicherheits-Check
         
         File f = LittleFS.open(filename, "r");
-        if (!f) return nullptr;
+        if (!f) return false;
         
         size_t fileSize = f.size();
-        uint8_t* pngFileData = (uint8_t*)heap_caps_malloc(fileSize, MALLOC_CAP_SPIRAM);
-        if (!pngFileData) { f.close(); return nullptr; }
+        uint8_t* pngFileData = job.alloc<uint8_t>(fileSize);
+        if (!pngFileData) { f.close(); return false; }
         
         size_t bytesRead = 0;
         while (bytesRead < fileSize) {
@@ -401,10 +924,7 @@ private:
         }
         f.close();
 
-        if (png->openRAM(pngFileData, bytesRead, pngAnimDrawCallback) != PNG_SUCCESS) {
-            heap_caps_free(pngFileData);
-            return nullptr;
-        }
+        if (png->openRAM(pngFileData, bytesRead, pngAnimDrawCallback) != PNG_SUCCESS) return false;
 
         int imgW = png->getWidth();
         int imgH = png->getHeight();
@@ -425,30 +945,11 @@ private:
         }
         if (frames < 1) frames = 1;
         
-        AnimatedIcon* anim = new AnimatedIcon();
-        anim->name = name; anim->width = frameW; anim->height = frameH;
-        anim->totalHeight = frameH * frames; anim->frameCount = frames; anim->lastUsed = millis();
-        
-        size_t numPixels = anim->width * anim->totalHeight;
-        anim->pixels = (uint16_t*)heap_caps_malloc(numPixels * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-        anim->alpha = (uint8_t*)heap_caps_malloc(numPixels * sizeof(uint8_t), MALLOC_CAP_SPIRAM);
-        anim->delays = (uint16_t*)heap_caps_malloc(frames * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-
-        if (!anim->pixels || !anim->alpha || !anim->delays) { 
-            if(anim->pixels) heap_caps_free(anim->pixels); 
-            if(anim->alpha) heap_caps_free(anim->alpha); 
-            if(anim->delays) heap_caps_free(anim->delays);
-            delete anim; png->close(); heap_caps_free(pngFileData); return nullptr; 
-        }
-
-        memset(anim->pixels, 0, numPixels * sizeof(uint16_t));
-        memset(anim->alpha, 0, numPixels * sizeof(uint8_t));
-
-        anim->totalTime = frames * delayMs;
-        for (int i=0; i<frames; i++) anim->delays[i] = delayMs;
+        if (!out.alloc(job, frameW, frameH, frames)) { png->close(); return false; }
+        for (int i=0; i<frames; i++) out.delays[i] = delayMs;
 
         PngAnimContext ctx;
-        ctx.pixels = anim->pixels; ctx.alpha = anim->alpha;
+        ctx.pixels = out.pixels; ctx.alpha = out.alpha;
         ctx.frameW = frameW; ctx.frameH = frameH; ctx.frames = frames;
         ctx.isVertical = isVertical; 
         ctx.isRotated = rotated;     
@@ -456,11 +957,8 @@ private:
         ctx.hasTransColor = (tColor != -1); ctx.transColor = (uint32_t)tColor;
 
         png->decode((void*)&ctx, 0);
-        
         png->close();
-        heap_caps_free(pngFileData); 
-        
-        return anim;
+        return true;
     }
 
     // --- PNG und Sprite Sheet Decoder ---
@@ -507,7 +1005,7 @@ private:
         return 1;
     }
 
-    CachedIcon* loadPngIconFromSheet(const SheetDef& sheet, int index) {
+    CachedIcon* loadPngIconFromSheet(const SheetDef& sheet, int index, DecodeScope& job) {
         if (!LittleFS.exists(sheet.filePath)) return nullptr;
         if (!png) return nullptr;
 
@@ -521,9 +1019,9 @@ private:
         CachedIcon* newIcon = new CachedIcon();
         newIcon->width = tileW; newIcon->height = tileH;
         newIcon->pixels = (uint16_t*)heap_caps_malloc(tileW * tileH * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-        newIcon->alpha = (uint8_t*)heap_caps_malloc(tileW * tileH * sizeof(uint8_t), MALLOC_CAP_SPIRAM);
+        newIcon->alpha = job.alloc<uint8_t>(tileW * tileH);
 
-        if (!newIcon->pixels || !newIcon->alpha) { delete newIcon; png->close(); return nullptr; }
+        if (!newIcon->pixels || !newIcon->alpha) { freeIcon(newIcon); png->close(); return nullptr; }
 
         PngExtractContext ctx;
         ctx.pixels = newIcon->pixels; ctx.alpha = newIcon->alpha;
@@ -539,10 +1037,16 @@ private:
         return newIcon;
     }
 
-    CachedIcon* loadIconFromSheet(const SheetDef& sheet, int index) {
+    // Kachel aus dem Tile-Pack des Sheets (wird beim ersten Zugriff erzeugt), sonst direkt aus BMP/PNG
+    CachedIcon* loadIconFromSheet(const SheetDef& sheet, int index, DecodeScope& job) {
+        if (openTilePack(sheet)) return loadPackTile(index);
+        return loadSourceTile(sheet, index, job);
+    }
+
+    CachedIcon* loadSourceTile(const SheetDef& sheet, int index, DecodeScope& job) {
         String lowerPath = sheet.filePath;
         lowerPath.toLowerCase();
-        if (lowerPath.endsWith(".png")) return loadPngIconFromSheet(sheet, index);
+        if (lowerPath.endsWith(".png")) return loadPngIconFromSheet(sheet, index, job);
 
         if (!LittleFS.exists(sheet.filePath)) return nullptr;
         File f = LittleFS.open(sheet.filePath, "r");
@@ -559,13 +1063,14 @@ private:
         CachedIcon* newIcon = new CachedIcon();
         newIcon->width = tileW; newIcon->height = tileH;
         newIcon->pixels = (uint16_t*)heap_caps_malloc(tileW * tileH * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
-        newIcon->alpha = (uint8_t*)heap_caps_malloc(tileW * tileH * sizeof(uint8_t), MALLOC_CAP_SPIRAM);
+        newIcon->alpha = job.alloc<uint8_t>(tileW * tileH);
         
         int startX = (index % sheet.cols) * tileW;
         int startY = (index / sheet.cols) * tileH; 
         
         size_t lineSize = tileW * 4; 
-        uint8_t* lineBuffer = (uint8_t*)heap_caps_malloc(lineSize, MALLOC_CAP_SPIRAM);
+        uint8_t* lineBuffer = job.alloc<uint8_t>(lineSize);
+        if (!newIcon->pixels || !newIcon->alpha || !lineBuffer) { freeIcon(newIcon); f.close(); return nullptr; }
         
         for (int y = 0; y < tileH; y++) {
             int bmpRow = flipY ? (height - 1 - (startY + y)) : (startY + y);
@@ -576,7 +1081,181 @@ private:
                 newIcon->alpha[y * tileW + x] = lineBuffer[x*4+3];
             }
         }
-        heap_caps_free(lineBuffer); f.close(); return newIcon;
+        f.close(); return newIcon;
+    }
+
+    // --- Tile-Pack ---
+    static uint32_t fileSize(const String& path) {
+        if (!LittleFS.exists(path)) return 0;
+        File f = LittleFS.open(path, "r");
+        uint32_t size = f ? f.size() : 0;
+        if (f) f.close();
+        return size;
+    }
+
+    // Öffnet das Pack zum Sheet. Fehlt es oder passt es nicht mehr zur Quelle, wird es neu erzeugt.
+    bool openTilePack(const SheetDef& sheet) {
+        if (isTilePack(sheet.filePath)) return tilePack.isOpen(sheet.filePath) || tilePack.open(sheet.filePath);
+
+        String packPath = tilePackPath(sheet.filePath);
+        if (tilePack.isOpen(packPath)) return true;
+        uint32_t sourceSize = fileSize(sheet.filePath);
+        if (tilePack.open(packPath, sourceSize)) return true;
+        if (!sourceSize || packPath == tilePackFailed) return false;
+
+        if (buildTilePack(sheet, packPath, sourceSize) && tilePack.open(packPath, sourceSize)) return true;
+        tilePackFailed = packPath;
+        return false;
+    }
+
+    // Ein read: Pixel und Run-Maske landen in einem Block, der direkt zum Cache-Eintrag wird
+    CachedIcon* loadPackTile(int index) {
+        size_t size = 0;
+        uint8_t* block = tilePack.readTile(index, size);
+        if (!block) return nullptr;
+        const TilePackHeader& h = tilePack.getHeader();
+        CachedIcon* newIcon = new CachedIcon();
+        newIcon->width = h.tileW; newIcon->height = h.tileH;
+        newIcon->pixels = (uint16_t*)block;
+        newIcon->runs = block + (size_t)h.tileW * h.tileH * sizeof(uint16_t);
+        newIcon->packed = true;
+        return newIcon;
+    }
+
+    // Schiebt die fertige Kachelzeile ins Pack
+    static void flushTileBand(TileBandContext* ctx) {
+        int sheetW = ctx->cols * ctx->tileW;
+        for (int c = 0; c < ctx->cols && ctx->ok; c++) {
+            for (int y = 0; y < ctx->tileH; y++) {
+                memcpy(ctx->tilePixels + y * ctx->tileW, ctx->pixels + y * sheetW + c * ctx->tileW, ctx->tileW * sizeof(uint16_t));
+                memcpy(ctx->tileAlpha + y * ctx->tileW, ctx->alpha + y * sheetW + c * ctx->tileW, ctx->tileW);
+            }
+            ctx->ok = ctx->writer->addTile(ctx->tilePixels, ctx->tileAlpha);
+        }
+    }
+
+    static int pngPackDrawCallback(PNGDRAW *pDraw) {
+        TileBandContext* ctx = (TileBandContext*)pDraw->pUser;
+        int y = pDraw->y;
+        if (!ctx->ok || y >= ctx->rows * ctx->tileH) return 0;
+        if (y % 16 == 0) yield();
+
+        uint8_t* src = (uint8_t*)pDraw->pPixels;
+        uint8_t* pPalette = (uint8_t*)pDraw->pPalette;
+        int pixelType = pDraw->iPixelType;
+        int sheetW = ctx->cols * ctx->tileW;
+        uint16_t* dst = ctx->pixels + (y % ctx->tileH) * sheetW;
+        uint8_t* dstA = ctx->alpha + (y % ctx->tileH) * sheetW;
+
+        for (int x = 0; x < sheetW && x < pDraw->iWidth; x++) {
+            uint8_t r=0, g=0, b=0, a=255;
+            if (pixelType == 3 && pPalette) { 
+                uint8_t idx = src[x];
+                if (ctx->hasTransColor && idx == (uint8_t)ctx->transColor) { a = 0; } 
+                else { r = pPalette[idx*3]; g = pPalette[idx*3+1]; b = pPalette[idx*3+2]; }
+            } else if (pixelType == 2) { 
+                int idx = x * 3;
+                r = src[idx]; g = src[idx+1]; b = src[idx+2];
+                if (ctx->hasTransColor) {
+                    uint32_t rgb = ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+                    if(rgb == ctx->transColor) a = 0;
+                }
+            } else if (pixelType == 6) { 
+                int idx = x * 4;
+                r = src[idx]; g = src[idx+1]; b = src[idx+2]; a = src[idx+3];
+            }
+            dst[x] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+            dstA[x] = a;
+        }
+
+        if (y % ctx->tileH == ctx->tileH - 1) flushTileBand(ctx);
+        return ctx->ok ? 1 : 0;
+    }
+
+    // Wandelt ein BMP/PNG-Sheet in ein Tile-Pack. Gepuffert wird nur eine Kachelzeile, nicht das ganze Sheet.
+    bool buildTilePack(const SheetDef& sheet, const String& packPath, uint32_t sourceSize) {
+        uint32_t t0 = millis();
+        String lowerPath = sheet.filePath;
+        lowerPath.toLowerCase();
+        bool isPng = lowerPath.endsWith(".png");
+        if (isPng && !png) return false;
+
+        // Maße aus dem Kopf der Quelle, Kachelgröße wie beim direkten Laden
+        int width = 0, height = 0;
+        uint32_t dataOffset = 0;
+        bool flipY = false;
+        File f;
+        if (isPng) {
+            if (png->open(sheet.filePath.c_str(), myOpen, myClose, myRead, mySeek, pngPackDrawCallback) != PNG_SUCCESS) return false;
+            width = png->getWidth(); height = png->getHeight();
+        } else {
+            f = LittleFS.open(sheet.filePath, "r");
+            uint8_t header[54];
+            if (!f || f.read(header, 54) != 54) { if (f) f.close(); return false; }
+            dataOffset = read32(header, 10);
+            width = (int32_t)read32(header, 18);
+            height = (int32_t)read32(header, 22);
+            flipY = height > 0;
+            if (height < 0) height = -height;
+        }
+
+        int cols = sheet.cols > 0 ? sheet.cols : 1;
+        TileBandContext ctx = {};
+        ctx.tileW = sheet.tileW > 0 ? sheet.tileW : width / cols;
+        ctx.tileH = sheet.tileH > 0 ? sheet.tileH : ctx.tileW;
+        ctx.cols = ctx.tileW > 0 ? min(cols, width / ctx.tileW) : 0;
+        ctx.rows = ctx.tileH > 0 ? height / ctx.tileH : 0;
+        int sheetW = ctx.cols * ctx.tileW;
+
+        TilePackWriter writer;
+        DecodeScope job(arena);
+        ctx.writer = &writer;
+        ctx.pixels = job.alloc<uint16_t>((size_t)sheetW * ctx.tileH);
+        ctx.alpha = job.alloc<uint8_t>((size_t)sheetW * ctx.tileH);
+        ctx.tilePixels = job.alloc<uint16_t>((size_t)ctx.tileW * ctx.tileH);
+        ctx.tileAlpha = job.alloc<uint8_t>((size_t)ctx.tileW * ctx.tileH);
+        ctx.ok = ctx.cols > 0 && ctx.rows > 0 && ctx.cols * ctx.rows <= 0xFFFF &&
+                 ctx.pixels && ctx.alpha && ctx.tilePixels && ctx.tileAlpha &&
+                 writer.begin(packPath, ctx.tileW, ctx.tileH, ctx.cols * ctx.rows, sourceSize);
+
+        if (isPng) {
+            if (ctx.ok) {
+                int tColor = png->getTransparentColor();
+                ctx.hasTransColor = (tColor != -1); ctx.transColor = (uint32_t)tColor;
+                png->decode((void*)&ctx, 0);
+            }
+            png->close();
+        } else if (ctx.ok) {
+            size_t lineSize = (size_t)width * 4;
+            uint8_t* lineBuffer = job.alloc<uint8_t>(lineSize);
+            ctx.ok = lineBuffer != nullptr;
+            for (int y = 0; y < ctx.rows * ctx.tileH && ctx.ok; y++) {
+                if (y % 16 == 0) yield();
+                int bmpRow = flipY ? (height - 1 - y) : y;
+                f.seek(dataOffset + (size_t)bmpRow * lineSize);
+                if (f.read(lineBuffer, lineSize) != lineSize) { ctx.ok = false; break; }
+                uint16_t* dst = ctx.pixels + (y % ctx.tileH) * sheetW;
+                uint8_t* dstA = ctx.alpha + (y % ctx.tileH) * sheetW;
+                for (int x = 0; x < sheetW; x++) {
+                    dst[x] = color565(lineBuffer[x*4+2], lineBuffer[x*4+1], lineBuffer[x*4]);
+                    dstA[x] = lineBuffer[x*4+3];
+                }
+                if (y % ctx.tileH == ctx.tileH - 1) flushTileBand(&ctx);
+            }
+        }
+        if (f) f.close();
+
+        bool ok = ctx.ok && writer.finish();
+        if (!ok) writer.abort();
+        // Das Pack darf das Dateisystem nicht füllen (Uploads, Downloads, Konfiguration), sonst bleibt es beim Quell-Sheet
+        if (ok && LittleFS.totalBytes() - LittleFS.usedBytes() < TILEPACK_FS_RESERVE) {
+            LittleFS.remove(packPath);
+            ok = false;
+        }
+
+        Serial.printf("[ICON] Tile-Pack %s: %s, %d Kacheln %dx%d, %lu ms\n", packPath.c_str(), ok ? "OK" : "FEHLER",
+                      ctx.cols * ctx.rows, ctx.tileW, ctx.tileH, (unsigned long)(millis() - t0));
+        return ok;
     }
 
     // --- Standard Callbacks (File I/O) ---
@@ -643,10 +1322,26 @@ private:
         return 1;
     }
 
-    static void* GIFOpen(const char *filename, int32_t *size) { return (void*)1; }
-    static void GIFClose(void *handle) { }
-    static int32_t GIFRead(GIFFILE *handle, uint8_t *buffer, int32_t length) { return 0; }
-    static int32_t GIFSeek(GIFFILE *handle, int32_t position) { return 0; }
+    // AnimatedGIF erkennt das Dateiende über iPos, die Callbacks müssen die Position nachführen
+    static void* GIFOpen(const char *filename, int32_t *size) { return myOpen(filename, size); }
+    static void GIFClose(void *handle) { myClose(handle); }
+
+    static int32_t GIFRead(GIFFILE *handle, uint8_t *buffer, int32_t length) {
+        File* f = (File*)handle->fHandle;
+        if (!f) return 0;
+        int32_t n = f->read(buffer, length);
+        if (n < 0) n = 0;
+        handle->iPos = f->position();
+        return n;
+    }
+
+    static int32_t GIFSeek(GIFFILE *handle, int32_t position) {
+        File* f = (File*)handle->fHandle;
+        if (!f) return 0;
+        f->seek(position);
+        handle->iPos = f->position();
+        return handle->iPos;
+    }
 
     static void GIFDrawCallback(GIFDRAW *pDraw) {
         GifConvertContext* ctx = (GifConvertContext*)pDraw->pUser;
@@ -674,152 +1369,116 @@ private:
         }
     }
 
-    bool downloadFile(String url, File& fOut) {
-        for (int redirects = 0; redirects < 3; redirects++) {
-            WiFiClientSecure client;
-            client.setInsecure();
-            
-            HTTPClient http;
-            http.begin(client, url);
-            http.setUserAgent("Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36");
-            
-            const char* headerKeys[] = {"Location"};
-            http.collectHeaders(headerKeys, 1);
-            http.setTimeout(5000); 
-            
-            int httpCode = http.GET();
-            
-            if (httpCode == HTTP_CODE_OK) {
-                int written = http.writeToStream(&fOut);
-                http.end();
-                return written > 0;
-            } 
-            else if (httpCode == 301 || httpCode == 302 || httpCode == 307 || httpCode == 308) {
-                String newUrl = http.header("Location");
-                http.end();
-                if (newUrl == "") return false;
-                if (newUrl.startsWith("/")) newUrl = "https://developer.lametric.com" + newUrl;
-                url = newUrl;
-                Serial.println("[ICON] Redirect: " + url);
-                continue; 
-            } 
-            else {
-                Serial.printf("[ICON] HTTP Error %d for %s\n", httpCode, url.c_str());
-                http.end();
-                return false;
+    // Heruntergeladenes PNG (/temp_dl.dat) als 32-Bit BMP nach /icons/ schreiben. LaMetric-Icons sind
+    // 8x8, das passt in eine Zeitscheibe.
+    bool convertPng(const String& id) {
+        String outName = "/icons/" + id + ".bmp";
+        bool success = false;
+        DecodeScope job(arena);
+        File fOut = LittleFS.open(outName, "w");
+        if (!fOut) return false;
+        PngDownloadContext ctx; ctx.fOut = &fOut;
+        if (png->open("/temp_dl.dat", myOpen, myClose, myRead, mySeek, pngDownloadDraw) == PNG_SUCCESS) {
+            ctx.w = png->getWidth();
+            int tColor = png->getTransparentColor();
+            ctx.hasTransColor = (tColor != -1); ctx.transColor = (uint32_t)tColor;
+
+            int h = png->getHeight();
+            writeBmpHeader(fOut, ctx.w, -h); 
+
+            ctx.lineBuffer = job.alloc<uint8_t>(ctx.w * 4);
+            if (ctx.lineBuffer) {
+                png->decode((void*)&ctx, 0); 
+                success = true;
+                Serial.println("[ICON] PNG Saved: " + outName);
             }
+            png->close();
         }
-        return false;
+        fOut.close();
+        if (!success) LittleFS.remove(outName); 
+        return success;
     }
 
-    bool downloadAndConvert(String id, String targetFolder, bool forceAnim) {
-        if (WiFi.status() != WL_CONNECTED) return false;
-        if (!png || !gif) return false;
+    // Öffnet src und legt Canvas, Frame-Puffer und Pack-Writer (outPath.tmp) an. Die Frame-Anzahl für
+    // den Pack-Kopf liefert getInfo(). Die Puffer belegen die Decode-Arena bis releaseGif().
+    bool beginGif(GifStream& gs, const char* src, const String& outPath) {
+        if (!gif || !gif->open(src, GIFOpen, GIFClose, GIFRead, GIFSeek, GIFDrawCallback)) return false;
+        gs.open = true;
+
+        GIFINFO info;
+        if (!gif->getInfo(&info) || info.iFrameCount <= 0 || info.iFrameCount > 0xFFFF) return false;
+        int w = gif->getCanvasWidth(), h = gif->getCanvasHeight();
+        if (w <= 0 || h <= 0) return false;
+        gs.frames = info.iFrameCount;
+        gs.scratch.open(arena);
+        gs.canvas = gs.scratch.alloc<uint8_t>((size_t)w * h * 4);
+        gs.framePixels = gs.scratch.alloc<uint16_t>((size_t)w * h);
+        gs.frameAlpha = gs.scratch.alloc<uint8_t>((size_t)w * h);
+        if (!gs.canvas || !gs.framePixels || !gs.frameAlpha) return false;
+
+        gs.outPath = outPath;
+        gs.writer.setScratch(&gs.scratch);
+        if (!gs.writer.begin(outPath, w, h, gs.frames)) return false;
+
+        gs.ctx = {gs.canvas, w, h, 0, 0, 0, 0, 0};
+        gs.frame = 0;
+        gs.prevDispose = 2;
+        return true;
+    }
 
-        LittleFS.remove("/temp_dl.dat");
-        bool success = false;
-        String outName = targetFolder + id + ".bmp";
-        String dlyName = targetFolder + id + ".dly"; 
-
-        if (forceAnim) {
-            String url = "https://developer.lametric.com/content/apps/icon_thumbs/" + id + ".gif";
-            Serial.println("[ICON] Downloading GIF: " + url);
-            File f = LittleFS.open("/temp_dl.dat", "w");
-            if (f && downloadFile(url, f)) {
-                f.close();
-                File fRead = LittleFS.open("/temp_dl.dat", "r");
-                size_t fSize = fRead.size();
-                uint8_t* gifRamBuffer = (uint8_t*)heap_caps_malloc(fSize, MALLOC_CAP_SPIRAM);
-                
-                if (gifRamBuffer && fSize > 50) {
-                    fRead.read(gifRamBuffer, fSize); fRead.close();
-                    if (gif->open(gifRamBuffer, fSize, GIFDrawCallback)) {
-                        GIFINFO info;
-                        if (gif->getInfo(&info) && info.iFrameCount > 0) {
-                            int w = gif->getCanvasWidth(), h = gif->getCanvasHeight();
-                            int frames = info.iFrameCount;
-                            int totalH = h * frames;
-                            size_t stripSize = w * totalH * 4, canvasSize = w * h * 4;
-                            
-                            uint8_t* stripBuffer = (uint8_t*)heap_caps_malloc(stripSize, MALLOC_CAP_SPIRAM);
-                            uint8_t* canvasBuffer = (uint8_t*)heap_caps_malloc(canvasSize, MALLOC_CAP_SPIRAM);
-                            
-                            if (stripBuffer && canvasBuffer) {
-                                memset(stripBuffer, 0, stripSize); 
-                                GifConvertContext ctx = {canvasBuffer, w, h, 0, 0, 0, 0, 0}; 
-                                int prevDispose = 2;
-                                
-                                File fDly = LittleFS.open(dlyName, "w");
-                                
-                                for (int i=0; i<frames; i++) {
-                                    if (i % 10 == 0) yield(); 
-                                    ctx.frameIndex = i;
-                                    if (prevDispose == 2) memset(canvasBuffer, 0, canvasSize); 
-                                    
-                                    int frameDelayMs = 0;
-                                    gif->playFrame(false, &frameDelayMs, &ctx); 
-                                    if (frameDelayMs < 20) frameDelayMs = 100; 
-                                    
-                                    if (fDly) {
-                                        uint16_t d = (uint16_t)frameDelayMs;
-                                        fDly.write((uint8_t*)&d, 2);
-                                    }
-                                    
-                                    memcpy(stripBuffer + (i*canvasSize), canvasBuffer, canvasSize);
-                                    prevDispose = ctx.dispose;
-                                }
-                                if (fDly) fDly.close();
-                                gif->close();
-                                
-                                File fOut = LittleFS.open(outName, "w");
-                                writeBmpHeader(fOut, w, totalH);
-                                for (int y = totalH - 1; y >= 0; y--) fOut.write(stripBuffer + (y * w * 4), w * 4);
-                                fOut.close();
-                                success = true;
-                                Serial.println("[ICON] GIF Converted: " + outName);
-                                heap_caps_free(stripBuffer); heap_caps_free(canvasBuffer);
-                            }
-                        }
-                    }
-                    heap_caps_free(gifRamBuffer);
-                } else if(fRead) fRead.close();
-            } else if (f) f.close();
-            LittleFS.remove("/temp_dl.dat");
+    // Dekodiert Frames, bis budgetMs ab t0 verbraucht sind (mindestens einen).
+    // 1 = alle Frames geschrieben, 0 = weiter in der nächsten Zeitscheibe, -1 = Fehler.
+    int stepGif(GifStream& gs, uint32_t t0, uint32_t budgetMs) {
+        size_t n = gs.ctx.width * gs.ctx.height;
+        while (gs.frame < gs.frames) {
+            gs.ctx.frameIndex = gs.frame;
+            if (gs.prevDispose == 2) memset(gs.canvas, 0, n * 4); 
+
+            int frameDelayMs = 0;
+            if (gif->playFrame(false, &frameDelayMs, &gs.ctx) < 0) return -1;
+            if (frameDelayMs < 20) frameDelayMs = 100; 
+            for (size_t i = 0; i < n; i++) {
+                const uint8_t* c = gs.canvas + i * 4;
+                gs.framePixels[i] = color565(c[2], c[1], c[0]);
+                gs.frameAlpha[i] = c[3];
+            }
+            if (!gs.writer.addFrame(gs.framePixels, gs.frameAlpha, (uint16_t)frameDelayMs)) return -1;
+            gs.prevDispose = gs.ctx.dispose;
+            gs.frame++;
+            if (millis() - t0 >= budgetMs) break;
         }
+        return gs.frame >= gs.frames ? 1 : 0;
+    }
 
-        if (!success && !forceAnim) {
-            String url = "https://developer.lametric.com/content/apps/icon_thumbs/" + id + ".png";
-            Serial.println("[ICON] Downloading PNG: " + url);
-            File f = LittleFS.open("/temp_dl.dat", "w");
-            if (f && downloadFile(url, f)) {
-                 f.close();
-                 File fOut = LittleFS.open(outName, "w");
-                 if(fOut) {
-                     PngDownloadContext ctx; ctx.fOut = &fOut;
-                     if (png->open("/temp_dl.dat", myOpen, myClose, myRead, mySeek, pngDownloadDraw) == PNG_SUCCESS) {
-                         ctx.w = png->getWidth();
-                         int tColor = png->getTransparentColor();
-                         ctx.hasTransColor = (tColor != -1); ctx.transColor = (uint32_t)tColor;
-
-                         int h = png->getHeight();
-                         writeBmpHeader(fOut, ctx.w, -h); 
-                         
-                         ctx.lineBuffer = (uint8_t*)heap_caps_malloc(ctx.w * 4, MALLOC_CAP_SPIRAM);
-                         if (ctx.lineBuffer) {
-                             png->decode((void*)&ctx, 0); 
-                             heap_caps_free(ctx.lineBuffer);
-                             success = true;
-                             Serial.println("[ICON] PNG Saved: " + outName);
-                         }
-                         png->close();
-                     }
-                     fOut.close();
-                     if(!success) LittleFS.remove(outName); 
-                 }
-            } else if (f) f.close();
-            LittleFS.remove("/temp_dl.dat");
-        }
-        return success;
+    // Fertiges Pack an seinen Platz
+    bool finishGif(GifStream& gs) {
+        if (!gs.writer.finish()) return false;
+        Serial.printf("[ICON] GIF Converted: %s (%d Frames %dx%d, %lu Bytes)\n", gs.outPath.c_str(), gs.frames,
+                      gs.ctx.width, gs.ctx.height, (unsigned long)gs.writer.getBytes());
+        return true;
+    }
+
+    // Gibt Decoder und Puffer frei; ohne finishGif() wird die halbfertige Datei gelöscht
+    void releaseGif(GifStream& gs) {
+        if (gs.open) gif->close();
+        gs.open = false;
+        gs.writer.abort();
+        gs.writer.setScratch(nullptr);
+        gs.scratch.close();
+        gs.canvas = nullptr; gs.framePixels = nullptr; gs.frameAlpha = nullptr;
+    }
+
+    // Schließt den vordersten Auftrag ab. Fehlschläge landen im Negativ-Cache, danach ist das Icon
+    // (bis zum Ablauf der Sperre) leer statt Platzhalter.
+    void finishFetch(bool ok) {
+        IconFetchJob& job = fetchQueue.front();
+        releaseGif(job.gif);
+        http.cancel();
+        LittleFS.remove("/temp_dl.dat");
+        if (ok) misses.forget(job.hash, job.anim);
+        else recordMiss(job.id, job.hash, job.anim, downloadMiss());
+        fetchQueue.pop_front();
+        iconGeneration++;
     }
 
 public:
@@ -840,220 +1499,517 @@ public:
 
         if (!LittleFS.exists("/icons")) LittleFS.mkdir("/icons");
         if (!LittleFS.exists("/iconsan")) LittleFS.mkdir("/iconsan");
+
+        // Vor den Caches, solange der PSRAM noch am Stück frei ist
+        if (!arena.begin(arenaSize)) Serial.printf("[ICON] Decode-Arena (%u KB) nicht verfügbar\n", (unsigned)(arenaSize / 1024));
+        iconCache.begin();
+        animCache.begin();
+        buildPlaceholders();
+        ensureCatalog();
     }
-    
-    String resolveAlias(String tag) {
-        String result = "";
-        if (LittleFS.exists("/catalog.json")) {
-            File f = LittleFS.open("/catalog.json", "r");
-            if (f) {
-                SpiRamJsonDocument* doc = new SpiRamJsonDocument(8192); 
-                if (!deserializeJson(*doc, f)) {
-                    if (doc->containsKey("aliases") && (*doc)["aliases"].containsKey(tag)) {
-                        result = (*doc)["aliases"][tag].as<String>();
-                    }
-                }
-                delete doc; f.close();
-            }
+
+    // Treibt den vordersten Download um höchstens budgetMs voran (aus loop()). Der Verbindungsaufbau läuft
+    // in einer eigenen Task, siehe HttpFetch. True = ein Icon ist fertig oder endgültig fehlgeschlagen,
+    // Inhalte mit Platzhaltern neu zeichnen.
+    bool processFetches(uint32_t budgetMs) {
+        if (fetchQueue.empty()) return false;
+        IconFetchJob& job = fetchQueue.front();
+        uint32_t t0 = millis();
+
+        if (job.stage == IconFetchJob::QUEUED) {
+            lastHttpCode = 0;
+            if (WiFi.status() != WL_CONNECTED) lastHttpCode = HTTPC_ERROR_NOT_CONNECTED;
+            if (lastHttpCode || !png || !gif) { finishFetch(false); return true; }
+            String url = iconBaseUrl + job.id + (job.anim ? ".gif" : ".png");
+            Serial.println("[ICON] Downloading: " + url);
+            LittleFS.remove("/temp_dl.dat");
+            http.start(url, "/temp_dl.dat");
+            job.stage = IconFetchJob::DOWNLOAD;
+        }
+
+        if (job.stage == IconFetchJob::DOWNLOAD) {
+            HttpFetch::State state = http.step(budgetMs);
+            lastHttpCode = http.getHttpCode();
+            if (state == HttpFetch::FETCH_FAILED) { finishFetch(false); return true; }
+            if (state != HttpFetch::FETCH_DONE) return false;
+            if (!job.anim) { finishFetch(convertPng(job.id)); return true; }
+            if (!beginGif(job.gif, "/temp_dl.dat", "/iconsan/" + job.id + ".ani")) { finishFetch(false); return true; }
+            job.stage = IconFetchJob::CONVERT;
+            if (millis() - t0 >= budgetMs) return false;
         }
-        return result;
-    }
 
-    CachedIcon* getIcon(String name) {
-        if (name.startsWith("ln:")) name = name.substring(3);
-        else if (name.startsWith("la:")) name = name.substring(3);
-        else if (name.startsWith("ic:")) name = name.substring(3);
+        int step = stepGif(job.gif, t0, budgetMs);
+        if (step == 0) return false;
+        finishFetch(step > 0 && finishGif(job.gif));
+        return true;
+    }
 
-        for (auto it = iconCache.begin(); it != iconCache.end(); ++it) {
-            if ((*it)->name == name) {
-                (*it)->lastUsed = millis();
-                if (it != iconCache.begin()) iconCache.splice(iconCache.begin(), iconCache, it);
-                return *it;
-            }
+    // --- Vorladen ---
+    // Merkt alle Bitmap-Icons eines Markup-Texts vor ({ic:}, {ln:}, {la:}, {an:}, {lt:}). Nur Namen
+    // einreihen, geladen wird in processPrefetch().
+    void prefetchText(const String& text) {
+        int i = 0;
+        while ((i = text.indexOf('{', i)) >= 0) {
+            int end = text.indexOf('}', i);
+            if (end < 0) break;
+            prefetchTag(text.substring(i + 1, end));
+            i = end + 1;
         }
-        for(const String& bad : failedIcons) if (bad == name) return nullptr;
+    }
 
-        CachedIcon* newIcon = nullptr;
-        bool foundInCatalog = false;
+    // Ein einzelnes Tag ohne Klammern (z.B. SensorItem::icon "la:37364"). Text-Icons und Formatierung zählen nicht.
+    void prefetchTag(const String& tag) {
+        if (tag.length() < 4 || tag[2] != ':') return;
+        String name = tag.substring(3);
+        if (tag.startsWith("ic:") || tag.startsWith("ln:")) queuePrefetch(name, false, false);
+        else if (tag.startsWith("la:") || tag.startsWith("an:")) queuePrefetch(name, true, false);
+        else if (tag.startsWith("lt:")) queuePrefetch(name, false, true);
+    }
 
-        if (LittleFS.exists("/catalog.json")) {
-            File f = LittleFS.open("/catalog.json", "r");
-            if (f) {
-                SpiRamJsonDocument* doc = new SpiRamJsonDocument(8192);
-                if (!deserializeJson(*doc, f)) {
-                    if (doc->containsKey("icons") && (*doc)["icons"].containsKey(name)) {
-                        String sheetName = (*doc)["icons"][name]["sheet"].as<String>();
-                        int sheetIndex = (*doc)["icons"][name]["index"].as<int>();
-                        
-                        if (doc->containsKey("sheets") && (*doc)["sheets"].containsKey(sheetName)) {
-                            SheetDef def;
-                            def.filePath = (*doc)["sheets"][sheetName]["file"].as<String>();
-                            def.cols = (*doc)["sheets"][sheetName]["cols"] | 1;
-                            foundInCatalog = true;
-                            
-                            delete doc; doc = nullptr; f.close();
-                            newIcon = loadIconFromSheet(def, sheetIndex);
-                        }
-                    }
-                }
-                if (doc) delete doc;
-                if (f) f.close();
-            }
+    // Lädt vorgemerkte Icons, bis budgetMs verbraucht sind (mindestens eins). Aus freier Zeit im Loop:
+    // ein Icon wird am Stück geladen, bei einem neuen Sheet inkl. Tile-Pack.
+    void processPrefetch(uint32_t budgetMs) {
+        uint32_t t0 = millis();
+        while (!prefetchQueue.empty()) {
+            IconPrefetch p = prefetchQueue.front();
+            prefetchQueue.pop_front();
+            String name = p.alias ? resolveAlias(p.name) : p.name;
+            if (name.length()) prefetchOne(name, p.anim);
+            if (millis() - t0 >= budgetMs) break;
         }
+    }
 
-        if (!foundInCatalog) {
-             if (LittleFS.exists("/icons/" + name + ".bmp")) {
-                  newIcon = loadBmpFile("/icons/" + name + ".bmp");
-             } else {
-                  bool isNumeric = true;
-                  for(unsigned int i=0; i<name.length(); i++) if(!isDigit(name[i])) isNumeric = false;
-                  
-                  if (isNumeric && name.length() > 0) {
-                      if (downloadAndConvert(name, "/icons/", false)) { 
-                          newIcon = loadBmpFile("/icons/" + name + ".bmp");
-                      } else failedIcons.push_back(name);
-                  } else failedIcons.push_back(name);
-             }
+    bool isPrefetching() const { return !prefetchQueue.empty(); }
+
+    bool isFetching() const { return !fetchQueue.empty(); }
+    size_t getFetchQueueSize() const { return fetchQueue.size(); }
+    // Steigt bei jedem abgeschlossenen Download; vorgerenderte Inhalte vergleichen damit
+    uint32_t getIconGeneration() const { return iconGeneration; }
+    // Quelle für numerische Icon-IDs, "<url><id>.png" bzw. ".gif" (config.json: system.icon_base_url)
+    void setIconBaseUrl(const String& url) { if (url.length()) iconBaseUrl = url; }
+
+    // Nach Upload oder Löschen von /catalog.json: Index beim nächsten Zugriff neu aufbauen
+    void invalidateCatalog() { catalogDirty = true; }
+
+    void ensureCatalog() {
+        if (!catalogDirty) return;
+        catalogDirty = false;
+        catalog.load("/catalog.json");
+        // Zuordnungen können sich geändert haben: geladene Icons und Fehlschläge verwerfen
+        clearCaches();
+    }
+
+    void clearCaches() {
+        iconCache.clear([this](CachedIcon* icon) { freeIcon(icon); });
+        animCache.clear([this](AnimatedIcon* anim) { freeAnim(anim); });
+        misses.clear();
+        // Sheets können ersetzt worden sein
+        tilePack.close();
+        tilePackFailed = "";
+        iconGeneration++;   // Vorgerenderte Lauftexte zeigen sonst die alten Icons weiter
+    }
+
+    // Erzeugt fehlende oder veraltete Tile- und Animations-Packs für den Katalog (beim Start, damit
+    // die Umwandlung nicht beim ersten Icon mitten in einer App passiert)
+    void prepareTilePacks() {
+        ensureCatalog();
+        for (uint16_t i = 0; i < catalog.getSheetCount(); i++) openTilePack(sheetDef(catalog.getSheet(i)));
+        for (uint16_t i = 0; i < catalog.getAnimCount(); i++) {
+            DecodeScope job(arena);
+            AnimatedIcon* anim = loadCatalogAnim(catalog.getAnim(i), job);
+            if (anim) freeAnim(anim);
         }
-        
-        if (newIcon) {
-            newIcon->name = name; 
-            newIcon->lastUsed = millis();
-            while (iconCache.size() >= MAX_CACHE_SIZE_STATIC && !iconCache.empty()) {
-                CachedIcon* old = iconCache.back(); iconCache.pop_back(); 
-                if(old->pixels) heap_caps_free(old->pixels); 
-                if(old->alpha) heap_caps_free(old->alpha); 
-                delete old;
+    }
+
+    void setCacheBudget(size_t bytes) { cacheBudget = bytes; }
+    // Vor begin()
+    void setDecodeArenaSize(size_t bytes) { arenaSize = bytes; }
+
+    // --- Benchmark: Kachel aus BMP/PNG gegen Tile-Pack ---
+    // Lädt 'count' über das Sheet verteilte Kacheln am Cache vorbei bis zum zeichenfertigen Icon
+    // (inkl. Run-Maske). Zeiten pro Kachel; pack_open_us enthält ggf. das Erzeugen des Packs.
+    String benchSheet(uint16_t sheetIdx, uint16_t count) {
+        ensureCatalog();
+        if (sheetIdx >= catalog.getSheetCount() || count == 0) return "{}";
+        const CatalogSheet& cs = catalog.getSheet(sheetIdx);
+        SheetDef def = sheetDef(cs);
+        uint32_t total = (uint32_t)max(1, (int)cs.cols) * max(1, (int)cs.rows);
+        uint32_t t[2] = {0, 0}, tOpen = 0;
+        uint16_t loaded[2] = {0, 0};
+
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 0 && isTilePack(def.filePath)) continue;
+            if (pass == 1) {
+                tilePack.close();
+                uint32_t t0 = micros();
+                bool ok = openTilePack(def);
+                tOpen = micros() - t0;
+                if (!ok) break;
+            }
+            for (uint16_t k = 0; k < count; k++) {
+                int index = (int)((uint32_t)k * total / count);
+                uint32_t t0 = micros();
+                DecodeScope job(arena);
+                CachedIcon* icon = pass == 0 ? loadSourceTile(def, index, job) : loadPackTile(index);
+                bool ok = icon && prepareRuns(icon);
+                uint32_t dt = micros() - t0;
+                if (icon) freeIcon(icon);
+                if (ok) { t[pass] += dt; loaded[pass]++; }
             }
-            iconCache.push_front(newIcon);
         }
-        return newIcon;
+
+        char json[192];
+        snprintf(json, sizeof(json), "{\"file\":\"%s\",\"tiles\":%u,\"src_us\":%lu,\"pack_open_us\":%lu,\"pack_us\":%lu}",
+                 def.filePath.c_str(), (unsigned)count,
+                 (unsigned long)(loaded[0] ? t[0] / loaded[0] : 0), (unsigned long)tOpen,
+                 (unsigned long)(loaded[1] ? t[1] / loaded[1] : 0));
+        return String(json);
     }
 
-    AnimatedIcon* getAnimatedIcon(String id) {
-        if (id.startsWith("la:")) id = id.substring(3);
-        else if (id.startsWith("ln:")) id = id.substring(3);
-        else if (id.startsWith("an:")) id = id.substring(3);
+    uint16_t getSheetCount() { ensureCatalog(); return catalog.getSheetCount(); }
+
+    // --- Benchmark: GIF-Umwandlung ---
+    // Wandelt path wie einen Download in ein Animations-Pack um und lädt es (Ergebnis wird verworfen).
+    // frame_bytes ist der gesamte Arbeitsspeicher der Umwandlung neben dem Decoder (Canvas, RGB565-Frame
+    // mit Alpha, Vorgänger und Delta-Puffer im Writer), unabhängig von der Frame-Anzahl.
+    // bmp_bytes: Größe im alten Format (32-Bit BMP + .dly) zum Vergleich.
+    String benchGif(const String& path) {
+        GifStream gs;
+        uint32_t t0 = micros();
+        int r = beginGif(gs, path.c_str(), "/bench_gif.ani") ? stepGif(gs, millis(), 0xFFFFFFFFu) : -1;
+        bool ok = r > 0 && finishGif(gs);
+        uint32_t dt = micros() - t0;
+        releaseGif(gs);
+        uint32_t outBytes = fileSize("/bench_gif.ani");
+        t0 = micros();
+        AnimatedIcon* anim = ok ? loadAnimPack("/bench_gif.ani") : nullptr;
+        uint32_t tLoad = micros() - t0;
+        size_t ram = anim ? anim->bytes : 0;
+        if (anim) freeAnim(anim);
+        LittleFS.remove("/bench_gif.ani");
+
+        size_t n = (size_t)gs.ctx.width * gs.ctx.height;
+        char json[288];
+        snprintf(json, sizeof(json), "{\"file\":\"%s\",\"ok\":%s,\"frames\":%d,\"w\":%d,\"h\":%d,\"us\":%lu,\"us_per_frame\":%lu,\"frame_bytes\":%u,\"out_bytes\":%lu,\"bmp_bytes\":%lu,\"load_us\":%lu,\"ram\":%u}",
+                 path.c_str(), ok ? "true" : "false", gs.frames, gs.ctx.width, gs.ctx.height, (unsigned long)dt,
+                 (unsigned long)(gs.frames ? dt / gs.frames : 0), (unsigned)(n * (4 + 3 + 2 + 4) + 4), (unsigned long)outBytes,
+                 (unsigned long)(54 + n * 4 * gs.frames + gs.frames * 2), (unsigned long)tLoad, (unsigned)ram);
+        return String(json);
+    }
 
-        for (auto it = animCache.begin(); it != animCache.end(); ++it) {
-            if ((*it)->name == id) { (*it)->lastUsed = millis(); return *it; }
+    // --- Benchmark: Katalog-Animation, alter Ladeweg (alle Frames ausgepackt im PSRAM) gegen Animations-Pack ---
+    // src_us: Sheet dekodieren + Run-Masken, pack_us: Pack lesen und Frame-Tabelle aufbauen,
+    // decode_us: Frame aus den Deltas herstellen (Mittel über einen Durchlauf).
+    // src_ram / pack_ram: belegter PSRAM im Cache; src_bytes / pack_bytes: Flash (Sheet bzw. Pack).
+    String benchAnim(const CatalogAnim& spec) {
+        String file = catalog.str(spec.file);
+        if (isAnimPack(file)) return "{}";
+        uint32_t t0 = micros();
+        DecodeScope job(arena);
+        AnimFrames src;
+        bool ok = readAnimSheet(file, spec.frameW, spec.delayMs, spec.rotated, src, job);
+        size_t runSize = 0;
+        uint8_t* runs = ok ? DisplayManager::buildRunMask(src.alpha, src.width, src.height * src.frameCount, 10, &runSize) : nullptr;
+        uint32_t tSrc = micros() - t0;
+        if (runs) heap_caps_free(runs);
+        // Wie früher im Cache: alle Frames, 8x8 vorskaliert auf 16x16
+        int scale = (src.width == 8 && src.height == 8) ? 2 : 1;
+        size_t srcRam = (size_t)src.width * src.height * src.frameCount * sizeof(uint16_t) * scale * scale + runSize * scale +
+                        src.frameCount * (sizeof(uint32_t) + sizeof(uint16_t));
+
+        // Pack ggf. anlegen, dann messen
+        AnimatedIcon* anim = loadCatalogAnim(spec, job);
+        if (anim) freeAnim(anim);
+        String packPath = animPackPath(file);
+        t0 = micros();
+        anim = loadAnimPack(packPath, fileSize(file), animPackParams(spec.frameW, spec.delayMs, spec.rotated));
+        uint32_t tPack = micros() - t0;
+        uint32_t tDecode = 0;
+        size_t packRam = 0;
+        int frames = 0;
+        if (anim) {
+            frames = anim->frameCount;
+            t0 = micros();
+            for (int i = 0; i < frames; i++) animFrame(anim, i);
+            tDecode = (micros() - t0) / frames;
+            packRam = anim->bytes;
+            freeAnim(anim);
         }
-        for(const String& bad : failedIcons) if (bad == id) return nullptr;
 
-        AnimatedIcon* anim = nullptr;
-        bool foundInCatalog = false;
+        char json[288];
+        snprintf(json, sizeof(json), "{\"file\":\"%s\",\"frames\":%d,\"w\":%d,\"h\":%d,\"src_us\":%lu,\"pack_us\":%lu,\"decode_us\":%lu,"
+                 "\"src_ram\":%u,\"pack_ram\":%u,\"src_bytes\":%lu,\"pack_bytes\":%lu}",
+                 file.c_str(), frames, src.width, src.height, (unsigned long)(ok ? tSrc : 0), (unsigned long)(anim ? tPack : 0),
+                 (unsigned long)tDecode, (unsigned)(ok ? srcRam : 0), (unsigned)packRam,
+                 (unsigned long)fileSize(file), (unsigned long)fileSize(packPath));
+        return String(json);
+    }
 
-        if (LittleFS.exists("/catalog.json")) {
-            File f = LittleFS.open("/catalog.json", "r");
-            if (f) {
-                SpiRamJsonDocument* doc = new SpiRamJsonDocument(8192);
-                if (!deserializeJson(*doc, f)) {
-                    if (doc->containsKey("animations") && (*doc)["animations"].containsKey(id)) {
-                        String file = (*doc)["animations"][id]["file"].as<String>();
-                        int frameW = (*doc)["animations"][id]["frame_width"] | 16;
-                        int delayMs = (*doc)["animations"][id]["delay"] | 100;
-                        bool rotated = (*doc)["animations"][id]["rotated"] | false; 
-
-                        foundInCatalog = true;
-                        delete doc; doc = nullptr; f.close();
-                        
-                        anim = loadAnimFromPngSheet(id, file, frameW, delayMs, rotated);
+    // --- Dauertest: PSRAM-Fragmentierung ---
+    // Lädt 'loads' zufällig gewählte Katalog-Kacheln und -Animationen in einen auf cacheKb verkleinerten
+    // Cache, so dass fast jeder Ladevorgang einen älteren Eintrag verdrängt. Jede zweite Kachel wird aus
+    // dem Quell-Sheet dekodiert statt aus dem Tile-Pack gelesen, jede zweite Animation aus dem Sheet neu
+    // kodiert (nur im Speicher), damit die Decode-Arena mitläuft. Der größte freie PSRAM-Block wird
+    // 32 Mal über den Lauf verteilt gemessen (largest_kb), danach sind die Caches leer und das Budget
+    // wieder das alte. largest_end_kb nach dem Leeren zeigt, was an Lücken dauerhaft bleibt.
+    String soakIcons(uint32_t loads, uint32_t cacheKb = 48) {
+        ensureCatalog();
+        uint16_t sheets = catalog.getSheetCount(), anims = catalog.getAnimCount();
+        if (loads == 0 || (sheets == 0 && anims == 0)) return "{}";
+
+        size_t savedBudget = cacheBudget;
+        clearCaches();
+        cacheBudget = (size_t)cacheKb * 1024;
+        size_t freeStart = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+        size_t largestStart = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+        size_t largestMin = largestStart;
+        uint32_t evictions = getCacheEvictions();
+        uint32_t rejected = arena.getRejected();
+        uint32_t failed = 0, decoded = 0, empty = 0;
+        uint32_t sampleEvery = max((uint32_t)1, loads / 32);
+        String samples;
+        uint32_t rng = 0x2545F491;
+        uint32_t t0 = millis();
+
+        for (uint32_t i = 0; i < loads; i++) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            bool isAnim = anims && (!sheets || rng % 8 == 0);
+            bool fromSource = (rng >> 8) & 1;
+            char name[24];
+            DecodeScope job(arena);
+
+            if (isAnim) {
+                uint16_t a = (rng >> 9) % anims;
+                snprintf(name, sizeof(name), "soak:a%u", a);
+                uint32_t hash = iconNameHash(name);
+                if (!animCache.find(name, hash)) {
+                    const CatalogAnim& spec = catalog.getAnim(a);
+                    String file = catalog.str(spec.file);
+                    AnimatedIcon* anim = nullptr;
+                    AnimFrames src;
+                    AnimPackWriter writer;
+                    writer.setScratch(&job);
+                    if (!fromSource || isAnimPack(file)) anim = loadCatalogAnim(spec, job);
+                    else if (readAnimSheet(file, spec.frameW, spec.delayMs, spec.rotated, src, job) && encodeAnim(src, writer, "", 0, 0)) {
+                        size_t size = 0;
+                        uint8_t* data = writer.takeRecords(size);
+                        anim = animFromPack(writer.getHeader(), data, size);
+                        decoded++;
+                    }
+                    if (anim) {
+                        anim->name = name;
+                        makeRoom(anim->bytes, true);
+                        animCache.insert(anim, hash);
+                    } else failed++;
+                }
+            } else {
+                uint16_t s = (rng >> 9) % sheets;
+                const CatalogSheet& cs = catalog.getSheet(s);
+                uint32_t total = (uint32_t)max(1, (int)cs.cols) * max(1, (int)cs.rows);
+                uint32_t index = (rng >> 13) % total;
+                snprintf(name, sizeof(name), "soak:%u:%lu", s, (unsigned long)index);
+                uint32_t hash = iconNameHash(name);
+                if (!iconCache.find(name, hash)) {
+                    SheetDef def = sheetDef(cs);
+                    CachedIcon* icon = fromSource ? loadSourceTile(def, index, job) : loadIconFromSheet(def, index, job);
+                    if (fromSource) decoded++;
+                    if (icon && prepareRuns(icon)) {
+                        icon->name = name;
+                        makeRoom(icon->bytes, false);
+                        iconCache.insert(icon, hash);
+                    } else {
+                        if (icon) freeIcon(icon);
+                        if (!icon && !fromSource && tilePack.isEmpty(index)) empty++;   // Leere Kachel, steht nicht im Pack
+                        else failed++;
                     }
                 }
-                if (doc) delete doc;
-                if (f) f.close();
             }
-        }
 
-        if (!foundInCatalog) {
-            String path = "/iconsan/" + id + ".bmp";
-            if (!LittleFS.exists(path)) {
-                bool isNumeric = true;
-                for(unsigned int i=0; i<id.length(); i++) if(!isDigit(id[i])) isNumeric = false;
-                if (isNumeric && id.length() > 0) {
-                    if (!downloadAndConvert(id, "/iconsan/", true)) { failedIcons.push_back(id); return nullptr; }
-                } else { failedIcons.push_back(id); return nullptr; }
+            if (i % sampleEvery == 0 || i == loads - 1) {
+                size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+                if (largest < largestMin) largestMin = largest;
+                if (samples.length()) samples += ",";
+                samples += String((unsigned long)(largest / 1024));
             }
-            anim = loadAnimFromFS(path, id);
+            if (i % 16 == 15) yield();
         }
-        
-        if (anim) {
-            while (animCache.size() >= MAX_CACHE_SIZE_ANIM && !animCache.empty()) {
-                AnimatedIcon* old = animCache.back(); animCache.pop_back();
-                if(old->pixels) heap_caps_free(old->pixels); 
-                if(old->alpha) heap_caps_free(old->alpha); 
-                if(old->delays) heap_caps_free(old->delays);
-                delete old;
-            }
-            animCache.push_front(anim);
-        } else failedIcons.push_back(id);
-        
-        return anim;
+
+        uint32_t dt = millis() - t0;
+        evictions = getCacheEvictions() - evictions;
+        clearCaches();
+        cacheBudget = savedBudget;
+
+        char json[512];
+        snprintf(json, sizeof(json), "{\"loads\":%lu,\"decoded\":%lu,\"empty\":%lu,\"failed\":%lu,\"evictions\":%lu,\"ms\":%lu,\"cache_kb\":%lu,"
+                 "\"arena_kb\":%u,\"arena_peak\":%u,\"arena_rejected\":%lu,\"free_start_kb\":%u,\"free_end_kb\":%u,"
+                 "\"largest_start_kb\":%u,\"largest_min_kb\":%u,\"largest_end_kb\":%u,\"largest_kb\":[",
+                 (unsigned long)loads, (unsigned long)decoded, (unsigned long)empty, (unsigned long)failed, (unsigned long)evictions, (unsigned long)dt,
+                 (unsigned long)cacheKb, (unsigned)(arena.getCapacity() / 1024), (unsigned)arena.getPeak(),
+                 (unsigned long)(arena.getRejected() - rejected), (unsigned)(freeStart / 1024),
+                 (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024), (unsigned)(largestStart / 1024),
+                 (unsigned)(largestMin / 1024), (unsigned)(heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) / 1024));
+        return String(json) + samples + "]}";
     }
 
-    void drawIcon(DisplayManager& display, int x, int y, String name, bool scaleTo16 = false) {
-        CachedIcon* icon = getIcon(name); 
-        if (!icon) return; 
-        
-        bool doUpscale = scaleTo16 && (icon->width == 8) && (icon->height == 8);
-        for (int iy = 0; iy < (doUpscale ? 16 : icon->height); iy++) {
-            for (int ix = 0; ix < (doUpscale ? 16 : icon->width); ix++) {
-                int screenX = x + ix; int screenY = y + iy;
-                if (screenX < 0 || screenX >= M_WIDTH || screenY < 0 || screenY >= M_HEIGHT) continue;
-                int srcX = doUpscale ? (ix/2) : ix;
-                int srcY = doUpscale ? (iy/2) : iy;
-                int i = srcY * icon->width + srcX;
-                if (icon->alpha[i] > 10) display.drawPixel(screenX, screenY, icon->pixels[i]);
+    String benchAnims() {
+        ensureCatalog();
+        String json = "[";
+        for (uint16_t i = 0; i < catalog.getAnimCount(); i++) {
+            if (i) json += ",";
+            json += benchAnim(catalog.getAnim(i));
+        }
+        return json + "]";
+    }
+
+    // Alle .gif in dir (z.B. /bench mit 8 bis 64 Frames), als JSON-Array
+    String benchGifs(const char* dir = "/bench") {
+        String json = "[";
+        File root = LittleFS.open(dir);
+        if (root && root.isDirectory()) {
+            for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+                String name = f.name();
+                int slash = name.lastIndexOf('/');
+                if (slash >= 0) name = name.substring(slash + 1);
+                f.close();
+                if (!name.endsWith(".gif") && !name.endsWith(".GIF")) continue;
+                if (json.length() > 1) json += ",";
+                json += benchGif(String(dir) + "/" + name);
             }
         }
+        return json + "]";
     }
 
-    void drawAnimatedIcon(DisplayManager& display, int x, int y, String id) {
-        AnimatedIcon* anim = getAnimatedIcon(id);
-        if (!anim) { display.drawPixel(x, y, display.color565(255, 0, 0)); return; }
+    IconCatalog& getCatalog() { return catalog; }
+    
+    String resolveAlias(const String& tag) {
+        ensureCatalog();
+        const char* target = catalog.findAlias(tag.c_str());
+        return target ? String(target) : String("");
+    }
+
+    // --- Handles ---
+    // Name einmal auflösen (Cache-Suche, bei Bedarf laden), danach nur noch über das Handle zugreifen.
+    // 0 = Icon nicht verfügbar, ICON_PENDING = wird gerade geladen (Platzhalter). Präfixe ln:/la:/ic:/an: werden entfernt.
+    IconHandle getIconHandle(const String& name) {
+        if (hasPrefix(name)) return getIconHandle(name.substring(3));
+        uint32_t hash = iconNameHash(name.c_str());
+        IconHandle h = iconCache.find(name.c_str(), hash);
+        if (!h) {
+            if (dropPrefetch(name, false)) prefetchLate++;
+            return loadIcon(name, hash);
+        }
+        CachedIcon* icon = iconCache.item(h);
+        if (icon->prefetched) { icon->prefetched = false; prefetchHits++; }
+        return h;
+    }
+
+    IconHandle getAnimHandle(const String& id) {
+        if (hasPrefix(id)) return getAnimHandle(id.substring(3));
+        uint32_t hash = iconNameHash(id.c_str());
+        IconHandle h = animCache.find(id.c_str(), hash);
+        if (!h) {
+            if (dropPrefetch(id, true)) prefetchLate++;
+            return loadAnim(id, hash);
+        }
+        AnimatedIcon* anim = animCache.item(h);
+        if (anim->prefetched) { anim->prefetched = false; prefetchHits++; }
+        return h;
+    }
+
+    CachedIcon* getIcon(IconHandle h) { return h == ICON_PENDING ? placeholderIcon() : iconCache.get(h); }
+    AnimatedIcon* getAnimatedIcon(IconHandle h) { return h == ICON_PENDING ? placeholderAnim() : animCache.get(h); }
+
+    // Gecachtes Handle (z.B. in einer RichTextList) prüfen und nur bei Verdrängung neu auflösen
+    CachedIcon* resolveIcon(const String& name, IconHandle& h) {
+        CachedIcon* icon = iconCache.get(h);
+        if (icon) return icon;
+        h = getIconHandle(name);
+        return iconItem(h);
+    }
+
+    AnimatedIcon* resolveAnim(const String& id, IconHandle& h) {
+        AnimatedIcon* anim = animCache.get(h);
+        if (anim) return anim;
+        h = getAnimHandle(id);
+        return animItem(h);
+    }
 
+    // Zeiger sind nur bis zum nächsten Laden eines Icons gültig (Verdrängung), zum Halten Handles verwenden
+    CachedIcon* getIcon(const String& name) { return iconItem(getIconHandle(name)); }
+    AnimatedIcon* getAnimatedIcon(const String& id) { return animItem(getAnimHandle(id)); }
+
+    void drawIcon(DisplayManager& display, int x, int y, CachedIcon* icon, bool scaleTo16 = false) {
+        if (!icon) return; 
+        if (scaleTo16 && icon->pixels2x) display.blitRGB565Masked(x, y, icon->pixels2x, 16, 16, icon->runs2x);
+        else display.blitRGB565Masked(x, y, icon->pixels, icon->width, icon->height, icon->runs);
+    }
+
+    void drawIcon(DisplayManager& display, int x, int y, const String& name, bool scaleTo16 = false) {
+        drawIcon(display, x, y, getIcon(name), scaleTo16);
+    }
+
+    // Pixel und Maske eines Frames in Anzeigegröße. Die Pixel liegen im Frame-Puffer der Animation und
+    // gelten bis zum nächsten Aufruf für einen anderen Frame.
+    const uint16_t* getAnimFrame(AnimatedIcon* anim, int frame) { return animFrame(anim, frame); }
+    static const uint8_t* animRuns(const AnimatedIcon* anim, int frame) { return anim->runs + anim->frames[frame].runs; }
+
+    // Aktueller Frame einer Animation anhand der globalen Zeit
+    int getAnimFrameIndex(AnimatedIcon* anim) {
         int currentFrameIdx = 0;
         
         if (anim->totalTime > 0) {
             unsigned long timeInCycle = millis() % anim->totalTime;
             unsigned long accumulatedTime = 0;
             for (int i = 0; i < anim->frameCount; i++) {
-                accumulatedTime += anim->delays[i];
+                accumulatedTime += anim->frames[i].delayMs;
                 if (timeInCycle < accumulatedTime) {
                     currentFrameIdx = i;
                     break;
                 }
             }
         }
-
-        int pixelsPerFrame = anim->width * anim->height;
-        int startPixelIdx = currentFrameIdx * pixelsPerFrame;
-        bool doUpscale = (anim->width == 8 && anim->height == 8);
-        
-        for (int iy = 0; iy < (doUpscale?16:anim->height); iy++) {
-            for (int ix = 0; ix < (doUpscale?16:anim->width); ix++) {
-                int screenX = x + ix; int screenY = y + iy;
-                if (screenX < 0 || screenX >= M_WIDTH || screenY < 0 || screenY >= M_HEIGHT) continue;
-                int srcX = doUpscale ? (ix/2) : ix;
-                int srcY = doUpscale ? (iy/2) : iy;
-                int i = startPixelIdx + (srcY * anim->width + srcX);
-                if (anim->alpha[i] > 10) display.drawPixel(screenX, screenY, anim->pixels[i]);
-            }
-        }
+        return currentFrameIdx;
     }
 
-    int getAnimWidth(String id) {
-        AnimatedIcon* anim = getAnimatedIcon(id);
-        if (anim) return (anim->width == 8) ? 16 : anim->width; 
-        return 16; 
-    }
-    
-    int getIconWidth(String name) {
-        CachedIcon* i = getIcon(name);
-        return i ? (i->width == 8 ? 16 : i->width) : 16; 
+    void drawAnimatedIcon(DisplayManager& display, int x, int y, AnimatedIcon* anim) {
+        if (!anim) { display.drawPixel(x, y, display.color565(255, 0, 0)); return; }
+
+        int currentFrameIdx = getAnimFrameIndex(anim);
+        display.blitRGB565Masked(x, y, animFrame(anim, currentFrameIdx), anim->width, anim->height,
+                                 animRuns(anim, currentFrameIdx));
     }
-    int getIconHeight(String name) {
-        CachedIcon* i = getIcon(name);
-        return i ? (i->height == 8 ? 16 : i->height) : 16; 
+
+    void drawAnimatedIcon(DisplayManager& display, int x, int y, const String& id) {
+        drawAnimatedIcon(display, x, y, getAnimatedIcon(id));
     }
-};
\ No newline at end of file
+
+    // Anzeigemaße (fehlende Icons belegen 16x16)
+    static int animWidth(const AnimatedIcon* anim) { return anim ? anim->width : 16; }
+    static int iconWidth(const CachedIcon* i) { return i ? (i->pixels2x ? 16 : i->width) : 16; }
+    static int iconHeight(const CachedIcon* i) { return i ? (i->pixels2x ? 16 : i->height) : 16; }
+
+    int getAnimWidth(const String& id) { return animWidth(getAnimatedIcon(id)); }
+    int getIconWidth(const String& name) { return iconWidth(getIcon(name)); }
+    int getIconHeight(const String& name) { return iconHeight(getIcon(name)); }
+
+    // --- Statistik ---
+    // Belegter PSRAM der beiden Caches (inkl. vorskalierter Varianten)
+    size_t getCacheBytes() { return iconCache.getBytes() + animCache.getBytes(); }
+    size_t getCacheBudget() { return cacheBudget; }
+    uint16_t getCacheCount() { return iconCache.getCount() + animCache.getCount(); }
+    uint32_t getCacheHits() { return iconCache.getHits() + animCache.getHits(); }
+    uint32_t getCacheMisses() { return iconCache.getMisses() + animCache.getMisses(); }
+    uint32_t getCacheEvictions() { return iconCache.getEvictions() + animCache.getEvictions(); }
+    // Aktuell gesperrte Namen und abgewiesene Ladeversuche
+    uint16_t getMissCount() { return misses.getCount(); }
+    uint32_t getMissBlocked() { return misses.getBlocked(); }
+    // Prefetch: vorgemerkt, geladen, beim ersten Abruf da, zu spät, ungenutzt verdrängt
+    uint32_t getPrefetchQueued() const { return prefetchQueued; }
+    uint32_t getPrefetchLoaded() const { return prefetchLoaded; }
+    uint32_t getPrefetchHits() const { return prefetchHits; }
+    uint32_t getPrefetchLate() const { return prefetchLate; }
+    uint32_t getPrefetchWasted() const { return prefetchWasted; }
+    size_t getPrefetchQueueSize() const { return prefetchQueue.size(); }
+    // Decode-Arena: Größe, höchster Füllstand, abgewiesene Aufträge
+    const DecodeArena& getDecodeArena() const { return arena; }
+};
@@ -0,0 +1,248 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <esp_heap_caps.h>
+#include "config.h"
+#include "DisplayManager.h"
+
+extern DisplayManager display;
+
+// --- Live-Vorschau: Delta-Stream des Panel-Bildes ---
+// Ein Client (/live) bekommt nach jedem gezeigten Frame nur die geänderten Pixel, zeilenweise
+// als Segmente (RLE-Lauf oder Literal). Alle LIVE_KEYFRAME_MS kommt ein komplettes Bild.
+// Gesendet wird nicht-blockierend: Solange der Client das letzte Paket nicht abgenommen hat,
+// werden neue Frames übersprungen. Das nächste Delta enthält dann alle Änderungen seitdem.
+//
+// Paket:   [Länge u32 LE][Typ 'K'|'D'][Zeilen u8] Zeile*
+// Zeile:   [y u8][Segmente u8] Segment*
+// Segment: [x u8][n u8] Bit 7 von n gesetzt = Lauf (eine Farbe folgt), sonst n Farben (RGB565 LE)
+#define LIVE_KEYFRAME_MS 5000
+#define LIVE_MIN_INTERVAL_MS 50   // max. 20 fps
+
+class LiveStream {
+private:
+    static const int MAX_SEG = 127;
+    static const size_t MAX_PACKET = 6 + M_HEIGHT * (2 + M_WIDTH * 3);
+
+    WiFiClient client;
+    bool active = false;
+    uint16_t* current = nullptr;   // Schnappschuss des aktuellen Frames
+    uint16_t* sent = nullptr;      // Stand beim Client
+    uint8_t* packet = nullptr;
+    size_t packetLen = 0;
+    size_t packetSent = 0;
+    uint32_t lastFrame = 0;        // display.getShownFrames() des letzten Pakets
+    unsigned long lastPacketTime = 0;
+    unsigned long lastKeyframe = 0;
+    bool needKeyframe = true;
+
+    uint32_t packets = 0;
+    uint32_t skipped = 0;
+    uint32_t bytes = 0;
+
+    static void putColor(uint8_t*& p, uint16_t c) { *p++ = c & 0xFF; *p++ = c >> 8; }
+
+    // Kodiert die geänderten Pixel einer Zeile (Keyframe: alle). Ohne Änderung bleibt p unverändert.
+    static uint8_t* encodeRow(uint8_t* p, int16_t y, const uint16_t* row, const uint16_t* prev, bool key) {
+        uint8_t* head = p;
+        p += 2;
+        uint8_t segs = 0;
+        int16_t x = 0;
+        while (x < M_WIDTH) {
+            if (!key && row[x] == prev[x]) { x++; continue; }
+            int16_t start = x;
+            uint16_t c = row[x];
+            // Lauf gleicher Farbe?
+            int16_t run = 1;
+            while (start + run < M_WIDTH && run < MAX_SEG && row[start + run] == c && (key || row[start + run] != prev[start + run])) run++;
+            if (run >= 3) {
+                *p++ = start; *p++ = 0x80 | run;
+                putColor(p, c);
+                x = start + run;
+            } else {
+                // Literal bis zum nächsten unveränderten Pixel oder zum nächsten Lauf
+                uint8_t* lenPos = p + 1;
+                *p++ = start; p++;
+                int16_t n = 0;
+                while (x < M_WIDTH && n < MAX_SEG && (key || row[x] != prev[x])) {
+                    if (x + 2 < M_WIDTH && row[x] == row[x + 1] && row[x] == row[x + 2] &&
+                        (key || (row[x + 1] != prev[x + 1] && row[x + 2] != prev[x + 2])) && n > 0) break;
+                    putColor(p, row[x]);
+                    x++; n++;
+                }
+                *lenPos = n;
+            }
+            segs++;
+        }
+        if (!segs) return head;
+        head[0] = y; head[1] = segs;
+        return p;
+    }
+
+    void encode(bool key) {
+        uint8_t* p = packet + 6;
+        uint8_t rows = 0;
+        for (int16_t y = 0; y < M_HEIGHT; y++) {
+            const uint16_t* row = current + y * M_WIDTH;
+            const uint16_t* prev = sent + y * M_WIDTH;
+            if (!key && memcmp(row, prev, M_WIDTH * sizeof(uint16_t)) == 0) continue;
+            uint8_t* end = encodeRow(p, y, row, prev, key);
+            if (end != p) { rows++; p = end; }
+        }
+        packetLen = p - packet;
+        uint32_t payload = packetLen - 4;
+        packet[0] = payload & 0xFF; packet[1] = (payload >> 8) & 0xFF;
+        packet[2] = (payload >> 16) & 0xFF; packet[3] = payload >> 24;
+        packet[4] = key ? 'K' : 'D';
+        packet[5] = rows;
+        packetSent = 0;
+
+        uint16_t* tmp = sent; sent = current; current = tmp;
+    }
+
+    // Schickt so viel wie der Socket gerade annimmt. False = Verbindung verloren.
+    bool flush() {
+        while (packetSent < packetLen) {
+            ssize_t r = send(client.fd(), packet + packetSent, packetLen - packetSent, MSG_DONTWAIT);
+            if (r > 0) { packetSent += r; bytes += r; continue; }
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            return false;
+        }
+        return true;
+    }
+
+    void stop() {
+        client.stop();
+        active = false;
+        packetLen = packetSent = 0;
+    }
+
+public:
+    // Übernimmt den Client des aktuellen HTTP-Requests. Ein neuer Client ersetzt den alten.
+    bool begin(WiFiClient c) {
+        if (!packet) {
+            current = (uint16_t*)heap_caps_malloc(M_WIDTH * M_HEIGHT * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+            sent = (uint16_t*)heap_caps_malloc(M_WIDTH * M_HEIGHT * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+            packet = (uint8_t*)heap_caps_malloc(MAX_PACKET, MALLOC_CAP_SPIRAM);
+        }
+        if (!current || !sent || !packet) return false;
+        if (active) stop();
+
+        client = c;
+        client.setNoDelay(true);
+        client.print(F("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n"));
+        active = true;
+        needKeyframe = true;
+        lastFrame = display.getShownFrames() - 1;
+        return true;
+    }
+
+    // Im Loop aufrufen. Kodiert höchstens ein Paket und blockiert nie auf den Socket.
+    void pump() {
+        if (!active) return;
+        if (!client.connected()) { stop(); return; }
+        if (packetSent < packetLen) {
+            if (!flush()) { stop(); return; }
+            if (packetSent < packetLen) return;
+        }
+
+        uint32_t frame = display.getShownFrames();
+        unsigned long now = millis();
+        if (frame == lastFrame && !needKeyframe && now - lastKeyframe < LIVE_KEYFRAME_MS) return;
+        if (now - lastPacketTime < LIVE_MIN_INTERVAL_MS) return;
+
+        // Frames, die zwischen zwei Paketen gezeigt wurden, sind übersprungen
+        if (frame - lastFrame > 1) skipped += frame - lastFrame - 1;
+        bool key = needKeyframe || now - lastKeyframe >= LIVE_KEYFRAME_MS;
+        display.captureFrame(current);
+        encode(key);
+        if (key) { lastKeyframe = now; needKeyframe = false; }
+        lastFrame = frame;
+        lastPacketTime = now;
+        packets++;
+        if (!flush()) stop();
+    }
+
+    bool isActive() { return active; }
+    uint32_t getPackets() { return packets; }
+    uint32_t getSkipped() { return skipped; }
+    uint32_t getBytes() { return bytes; }
+};
+
+// --- Vorschau-Seite im Flash ---
+const char LIVE_HTML[] PROGMEM = R"rawliteral(
+<!DOCTYPE html>
+<html>
+<head>
+  <meta charset="utf-8">
+  <title>Matrix Live</title>
+  <style>
+    body { background: #111; color: #aaa; font-family: Arial, sans-serif; text-align: center; }
+    canvas { width: 768px; max-width: 96vw; image-rendering: pixelated; background: #000; border: 1px solid #333; }
+  </style>
+</head>
+<body>
+  <h3>Matrix Live</h3>
+  <canvas id="c" width="128" height="64"></canvas>
+  <p id="s">verbinde...</p>
+<script>
+const W = 128, H = 64;
+const ctx = document.getElementById('c').getContext('2d');
+const img = ctx.createImageData(W, H);
+const info = document.getElementById('s');
+let frames = 0, bytes = 0;
+
+function put(x, y, c) {
+  const i = (y * W + x) * 4;
+  img.data[i] = ((c >> 11) & 31) * 255 / 31;
+  img.data[i + 1] = ((c >> 5) & 63) * 255 / 63;
+  img.data[i + 2] = (c & 31) * 255 / 31;
+  img.data[i + 3] = 255;
+}
+
+function apply(p) {
+  let o = 2;
+  const rows = p[1];
+  for (let r = 0; r < rows; r++) {
+    const y = p[o++], segs = p[o++];
+    for (let s = 0; s < segs; s++) {
+      let x = p[o++], n = p[o++];
+      if (n & 0x80) {
+        const c = p[o] | (p[o + 1] << 8); o += 2;
+        for (n &= 0x7F; n > 0; n--) put(x++, y, c);
+      } else {
+        for (; n > 0; n--, o += 2) put(x++, y, p[o] | (p[o + 1] << 8));
+      }
+    }
+  }
+  ctx.putImageData(img, 0, 0);
+  frames++;
+}
+
+async function run() {
+  const res = await fetch('/live', { cache: 'no-store' });
+  const reader = res.body.getReader();
+  let buf = new Uint8Array(0);
+  while (true) {
+    const { value, done } = await reader.read();
+    if (done) break;
+    bytes += value.length;
+    const next = new Uint8Array(buf.length + value.length);
+    next.set(buf); next.set(value, buf.length); buf = next;
+    while (buf.length >= 4) {
+      const len = buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
+      if (buf.length < 4 + len) break;
+      apply(buf.subarray(4, 4 + len));
+      buf = buf.slice(4 + len);
+    }
+  }
+}
+
+setInterval(() => { info.textContent = frames + ' fps, ' + (bytes / 1024).toFixed(1) + ' KB/s'; frames = 0; bytes = 0; }, 1000);
+function loop() { run().catch(() => {}).finally(() => { info.textContent = 'getrennt, neuer Versuch...'; setTimeout(loop, 2000); }); }
+loop();
+</script>
+</body>
+</html>
+)rawliteral";
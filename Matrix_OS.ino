@@ -18,6 +18,9 @@
 #include "ConfigManager.h"
 #include "WeatherApp.h"
 #include "PongApp.h"
+#include "Benchmark.h"
+#include "ScrollStrip.h"
+#include "PerfMonitor.h"
 
 WeatherApp weatherApp;
 PongApp appPong;
@@ -53,6 +56,54 @@ void triggerSysInfo(int durationSec) {
     sysInfoOverlayEndTime = millis() + (durationSec * 1000UL);
 }
 
+// --- Frame-Telemetrie: Stufen-Zeiten pro App, alle 10 s an matrix/status/perf und /perf ---
+PerfMonitor perf;
+
+// --- Benchmark: wird per MQTT angefordert und im nächsten Frame ausgeführt ---
+Benchmark benchmark;
+bool benchmarkRequested = false;
+uint32_t iconSoakLoads = 0;        // Fragmentierungs-Dauertest (matrix/cmd/icon_soak), 0 = keiner angefordert
+uint32_t iconSoakCacheKb = 48;
+
+// --- Frame-Scheduler ---
+// Gerendert wird nur, wenn die früheste Deadline (App, Overlay, Fade, Debug-HUD) fällig ist
+// oder ein Ereignis requestFrame() aufruft. Dazwischen schläft der Loop-Task, Netzwerk und
+// Webserver werden spätestens alle NET_POLL_MS bedient.
+const uint32_t NET_POLL_MS = 20;
+const uint32_t AUTO_CHECK_MS = 500;   // Auto-Modus prüft seine Wechsel-Bedingungen
+const uint32_t FETCH_SLICE_MS = 8;    // Zeitscheibe für Icon-Downloads pro Loop-Durchlauf
+const uint32_t FETCH_POLL_MS = 2;     // Kürzerer Schlaf, solange Downloads laufen
+const uint32_t PREFETCH_MIN_IDLE_MS = 6;   // Vorgemerkte Icons nur laden, wenn bis zum nächsten Frame so viel Zeit bleibt
+unsigned long nextFrameAt = 0;
+volatile bool frameRequested = true;
+TaskHandle_t loopTaskHandle = nullptr;
+uint32_t loopIterations = 0;
+uint32_t frameWakes = 0;
+bool iconsChanged = false;
+
+void requestFrame() {
+    frameRequested = true;
+    // Aus einem fremden Task (z.B. WiFi-Events) den schlafenden Loop sofort wecken
+    if (loopTaskHandle && xTaskGetCurrentTaskHandle() != loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+}
+
+void requestBenchmark() {
+    benchmarkRequested = true;
+    requestFrame();
+}
+
+void requestIconSoak(uint32_t loads, uint32_t cacheKb) {
+    iconSoakLoads = loads;
+    iconSoakCacheKb = cacheKb;
+    requestFrame();
+}
+
+// Vom WebManager nach Upload/Löschen von /catalog.json: Icon-Index beim nächsten Zugriff neu aufbauen
+void catalogChanged() {
+    iconManager.invalidateCatalog();
+    requestFrame();
+}
+
 struct BootLogEntry { String text; uint16_t color; };
 std::vector<BootLogEntry> bootLogs; 
 int bootLogCounter = 1;
@@ -75,12 +126,13 @@ OverlayMessage currentOverlay;
 int overlayScrollX = 0;
 unsigned long overlayLastScrollStep = 0;
 int overlayTextWidth = 0;
+RichTextList overlayText;  // Beim Start des Overlays kompiliert
+ScrollStrip overlayStrip;  // Vorgerenderter Lauftext für lange Overlays
 int overlayBoxWidth = 0;
 bool overlayIsScrolling = false;
 int overlayBoxX = 0;
 int overlayBoxY = 0;
 
-const int frameDelay = 10;
 float fadeVal = 1.0;
 const float fadeStep = 0.1; 
 AppMode displayedApp = WORDCLOCK;
@@ -91,18 +143,21 @@ void queueOverlay(String msg, int durationSec, String colorName, int scrollSpeed
     Serial.print("Overlay Queued: ");
     Serial.println(msg);
     if (overlayQueue.size() < 5) overlayQueue.push_back({OVL_TEXT, msg, durationSec, colorName, scrollSpeed, false});
+    requestFrame();
 }
 
 void forceOverlay(String msg, int durationSec, String colorName) {
     overlayQueue.clear();
     isOverlayActive = false;
     overlayQueue.push_back({OVL_TEXT, msg, durationSec, colorName, 0, true});
+    requestFrame();
 }
 
 void queueAnimation(OverlayType animType, int durationSec) {
     if (currentApp == PONG || displayedApp == PONG) return; 
     Serial.println("Animation Queued");
     if (overlayQueue.size() < 5) overlayQueue.push_back({animType, "", durationSec, "", 0, false});
+    requestFrame();
 }
 
 void status(const String& msg, uint16_t color = 0xFFFF) {
@@ -135,7 +190,7 @@ void status(const String& msg, uint16_t color = 0xFFFF) {
 void processAndDrawOverlay(DisplayManager& display) {
     unsigned long now = millis();
     if (isOverlayActive) { 
-        if (now > overlayEndTime) isOverlayActive = false;
+        if (now > overlayEndTime) { isOverlayActive = false; overlayStrip.release(); }
     }
     
     if (!isOverlayActive && !overlayQueue.empty()) {
@@ -147,7 +202,8 @@ void processAndDrawOverlay(DisplayManager& display) {
         if (currentOverlay.type == OVL_TEXT) {
             Serial.println("Overlay Started: " + currentOverlay.text);
             String finalMsg = "{c:" + currentOverlay.colorName + "}" + currentOverlay.text;
-            overlayTextWidth = richTextOverlay.getTextWidth(display, finalMsg, "Medium");
+            richTextOverlay.compileInto(display, finalMsg, "Medium", overlayText);
+            overlayTextWidth = overlayText.width;
             
             int boxH = 34;
             overlayBoxWidth = 104; 
@@ -155,6 +211,7 @@ void processAndDrawOverlay(DisplayManager& display) {
             if (overlayTextWidth > (overlayBoxWidth - 10)) { 
                 overlayBoxWidth = M_WIDTH;
                 overlayIsScrolling = true; 
+                overlayStrip.build(display, richTextOverlay, overlayText);
             }
             
             overlayBoxX = (M_WIDTH - overlayBoxWidth) / 2;
@@ -166,7 +223,6 @@ void processAndDrawOverlay(DisplayManager& display) {
     
     if (isOverlayActive) {
         if (currentOverlay.type == OVL_TEXT) {
-            String finalMsg = "{c:" + currentOverlay.colorName + "}" + currentOverlay.text;
             int boxH = 34;
 
             display.dimRect(overlayBoxX, overlayBoxY, overlayBoxWidth, boxH); 
@@ -177,7 +233,7 @@ void processAndDrawOverlay(DisplayManager& display) {
             int textY = overlayBoxY + (boxH / 2) + 5;
             
             if (!overlayIsScrolling) { 
-                richTextOverlay.drawCentered(display, textY, finalMsg, "Medium");
+                richTextOverlay.drawCentered(display, textY, overlayText);
             } else {
                 int speed = currentOverlay.scrollSpeed;
                 if (speed < 1) speed = 30; 
@@ -189,7 +245,9 @@ void processAndDrawOverlay(DisplayManager& display) {
                     int totalDist = overlayBoxWidth + overlayTextWidth + 20;
                     if (overlayScrollX < (startX - totalDist)) overlayScrollX = startX;
                 }
-                richTextOverlay.drawString(display, overlayScrollX, textY, finalMsg, "Medium");
+                RichClip box;
+                box.x = overlayBoxX; box.y = overlayBoxY; box.w = overlayBoxWidth; box.h = boxH;
+                overlayStrip.draw(display, richTextOverlay, overlayScrollX, textY, overlayText, box);
             }
             
             int totalDur = currentOverlay.durationSec * 1000;
@@ -242,6 +300,7 @@ void drawDebugOverlay(DisplayManager& display);
 
 void setup() {
   Serial.begin(115200);
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
   if (!display.begin()) while(1);
   
   status("Check Storage...", display.color565(255, 255, 255));
@@ -253,10 +312,16 @@ void setup() {
   } else { 
       status("Load Config...", display.color565(255, 255, 0)); 
       configManager.begin();
+      ScrollStrip::setMaxBytes(configManager.system.scroll_strip_max_kb * 1024);
+      iconManager.setCacheBudget(configManager.system.icon_cache_kb * 1024);
+      iconManager.setDecodeArenaSize(configManager.system.decode_arena_kb * 1024);
+      iconManager.setIconBaseUrl(configManager.system.icon_base_url);
       if (configManager.autoMode.enabled) currentApp = AUTO;
       brightness = configManager.system.startup_brightness; 
       status("Load Icons...", display.color565(255, 255, 0));
       iconManager.begin();
+      status("Pack Icons...", display.color565(255, 255, 0));
+      iconManager.prepareTilePacks();
   }
   
   status("Connect WiFi...", display.color565(255, 255, 255));
@@ -305,21 +370,63 @@ static bool wasDisplayOff = false;
 
 void loop() {
     unsigned long now = millis();
+    loopIterations++;
     
     if (now - lastDebugTick > 2000) {
         Serial.print(F("Tick: "));
         Serial.print(now / 1000);
         Serial.print(F(" | IP: ")); Serial.print(WiFi.localIP()); 
-        Serial.print(F(" | Heap: ")); Serial.println(ESP.getFreeHeap());
+        Serial.print(F(" | Heap: ")); Serial.print(ESP.getFreeHeap());
+        Serial.print(F(" | Icons: ")); Serial.print(iconManager.getCacheBytes() / 1024); Serial.print(F("KB"));
+        Serial.printf(" (%u, H/M/E %u/%u/%u)", (unsigned)iconManager.getCacheCount(), (unsigned)iconManager.getCacheHits(),
+                      (unsigned)iconManager.getCacheMisses(), (unsigned)iconManager.getCacheEvictions());
+        Serial.printf(" | Icon-Sperren: %u | Downloads: %u", (unsigned)iconManager.getMissCount(), (unsigned)iconManager.getFetchQueueSize());
+        Serial.printf(" | Prefetch: %u (geladen/Treffer/spät/verdrängt %u/%u/%u/%u)", (unsigned)iconManager.getPrefetchQueueSize(),
+                      (unsigned)iconManager.getPrefetchLoaded(), (unsigned)iconManager.getPrefetchHits(),
+                      (unsigned)iconManager.getPrefetchLate(), (unsigned)iconManager.getPrefetchWasted());
+        const DecodeArena& arena = iconManager.getDecodeArena();
+        Serial.printf(" | Decode-Arena: %u/%u KB (abgewiesen %u)", (unsigned)(arena.getPeak() / 1024),
+                      (unsigned)(arena.getCapacity() / 1024), (unsigned)arena.getRejected());
+
+        // Trefferquote des Glyph-Atlas seit dem letzten Tick
+        GlyphAtlas& atlas = display.getGlyphAtlas();
+        uint32_t lookups = atlas.getHits() + atlas.getMisses();
+        Serial.print(F(" | Glyph-Hits: ")); Serial.print(lookups ? atlas.getHits() * 100 / lookups : 100); Serial.print(F("%"));
+        atlas.resetStats();
+
+        // Dirty-Rect Statistik: durchschnittlich gepushte Pixel pro Frame seit dem letzten Tick
+        static uint32_t lastTickPushed = 0, lastTickFrames = 0;
+        uint32_t frames = display.getShownFrames() - lastTickFrames;
+        uint32_t pushed = display.getTotalPushedPixels() - lastTickPushed;
+        Serial.print(F(" | Px/Frame: ")); Serial.print(frames ? pushed / frames : 0);
+        Serial.print(F(" (")); Serial.print(frames); Serial.print(F(" Frames)"));
+
+        // Scheduler: Loop-Durchläufe und Render-Wakeups seit dem letzten Tick
+        static uint32_t lastTickLoops = 0, lastTickWakes = 0;
+        Serial.print(F(" | Loops: ")); Serial.print(loopIterations - lastTickLoops);
+        Serial.print(F(" | Wakes: ")); Serial.println(frameWakes - lastTickWakes);
+        lastTickLoops = loopIterations;
+        lastTickWakes = frameWakes;
+        lastTickPushed = display.getTotalPushedPixels();
+        lastTickFrames = display.getShownFrames();
         lastDebugTick = now;
     }
 
     network.loop(); 
     webServer.handle();
+
+    // Icon-Downloads in kleinen Zeitscheiben weitertreiben, statt den Loop zu blockieren
+    if (iconManager.processFetches(FETCH_SLICE_MS)) {
+        iconsChanged = true;
+        requestFrame();
+    }
+
+    if (perf.update(now)) network.publish("matrix/status/perf", perf.getReport());
     
-    static unsigned long lastFrameTime = 0;
-    if (now - lastFrameTime >= frameDelay) {
-        lastFrameTime = now;
+    if (frameRequested || (long)(now - nextFrameAt) >= 0) {
+        frameRequested = false;
+        frameWakes++;
+        uint32_t due = IDLE_FRAME_MS; // Jede aktive Quelle kann die Wartezeit verkürzen
         
         display.setBrightness(brightness);
         
@@ -397,6 +504,7 @@ void loop() {
                     targetApp = getAppModeByName(configManager.autoMode.apps[autoAppIndex]);
                 }
             }
+            due = min(due, AUTO_CHECK_MS);
         }
 
         bool appChanged = false;
@@ -411,6 +519,7 @@ void loop() {
                 appChanged = true;
                 
                 autoAppFallbackTimer = millis(); 
+                display.endIndexed(); // Jede App startet auf der RGB565-Ebene
                 App* newApp = getAppInstance(displayedApp);
                 if (newApp) newApp->onActive();
             }
@@ -426,6 +535,24 @@ void loop() {
             }
         }
         display.setAppFade(fadeVal);
+        if (isFading) due = FRAME_INTERVAL_MS;
+
+        // Fertig geladene Icons ersetzen ihre Platzhalter: einmal komplett neu zeichnen
+        bool iconsArrived = iconsChanged;
+        iconsChanged = false;
+
+        bool benchmarkRan = false;
+        if (benchmarkRequested) {
+            benchmarkRequested = false;
+            network.publish("matrix/status/benchmark", benchmark.run(display, appPlasma, appWordClock, iconManager));
+            benchmarkRan = true;
+        }
+        if (iconSoakLoads) {
+            uint32_t loads = iconSoakLoads;
+            iconSoakLoads = 0;
+            network.publish("matrix/status/icon_soak", iconManager.soakIcons(loads, iconSoakCacheKb));
+            benchmarkRan = true;
+        }
         
         if (brightness > 0) {
              bool justTurnedOn = wasDisplayOff;
@@ -433,10 +560,11 @@ void loop() {
 
              bool overlayPending = !overlayQueue.empty();
              
-             bool forceRedraw = appChanged || isOverlayActive || overlayPending || (wasOverlayActive && !isOverlayActive) ||
-                                justTurnedOn || isFading;
+             // Overlay und Debug-Anzeige liegen auf eigenen Ebenen und erzwingen keinen App-Redraw mehr
+             bool forceRedraw = appChanged || justTurnedOn || isFading || benchmarkRan || iconsArrived;
              
              bool screenUpdated = false;
+             uint32_t tStage = micros();
              switch(displayedApp) {
                case WORDCLOCK:   screenUpdated = appWordClock.draw(display, forceRedraw); break;
                case SENSORS:     screenUpdated = appSensors.draw(display, forceRedraw); break;
@@ -447,37 +575,72 @@ void loop() {
                case PONG:        screenUpdated = appPong.draw(display, forceRedraw); break;
                case OFF:         display.clear(); screenUpdated = true; break;
              }
+             perf.addApp(displayedApp, micros() - tStage);
+             App* shownApp = getAppInstance(displayedApp);
+             if (shownApp) due = min(due, shownApp->nextFrameDueMs(millis()));
              
-             if (isOverlayActive || overlayPending) { 
-                 display.setAppFade(1.0);
-                 processAndDrawOverlay(display);
-                 if (isOverlayActive) screenUpdated = true;
+             // --- Overlay-Ebene: wird pro Frame neu gezeichnet, die App darunter bleibt unangetastet ---
+             display.setLayer(LAYER_OVERLAY);
+             if (isOverlayActive || wasOverlayActive || overlayPending) {
+                 tStage = micros();
+                 if (isOverlayActive || wasOverlayActive) display.clearLayer();
+                 if (isOverlayActive || overlayPending) processAndDrawOverlay(display);
+                 perf.addStage(PERF_OVERLAY, micros() - tStage);
              }
+             if (isOverlayActive || wasOverlayActive) screenUpdated = true;
+             if (isOverlayActive || !overlayQueue.empty()) due = FRAME_INTERVAL_MS;
              
              // --- NEU: Zeigt Overlay, wenn config.json es sagt ODER der MQTT Timer noch läuft ---
              bool showDebug = configManager.system.show_debug_overlay || (now < sysInfoOverlayEndTime);
              
+             // --- HUD-Ebene: Debug-Anzeige nur einmal pro Sekunde neu zeichnen ---
+             static bool debugShown = false;
+             static unsigned long lastDebugRedraw = 0;
+             display.setLayer(LAYER_HUD);
              if (showDebug) {
-                 static unsigned long lastDebugRedraw = 0;
-                 if (now - lastDebugRedraw >= 1000) {
-                     screenUpdated = true;
-                     lastDebugRedraw = now;
-                 }
-                 if (screenUpdated || forceRedraw) {
+                 if (!debugShown || justTurnedOn || now - lastDebugRedraw >= 1000) {
+                     tStage = micros();
+                     display.clearLayer();
                      drawDebugOverlay(display);
-                     screenUpdated = true; 
+                     perf.addStage(PERF_HUD, micros() - tStage);
+                     lastDebugRedraw = now;
+                     debugShown = true;
+                     screenUpdated = true;
                  }
+                 due = min(due, (uint32_t)(lastDebugRedraw + 1000 - now));
+             } else if (debugShown) {
+                 display.clearLayer();
+                 debugShown = false;
+                 screenUpdated = true;
              }
+             display.setLayer(LAYER_APP);
 
-             if (screenUpdated) display.show();
+             if (screenUpdated) {
+                 tStage = micros();
+                 display.show();
+                 perf.addStage(PERF_SHOW, micros() - tStage);
+             }
              wasOverlayActive = isOverlayActive;
         } else { 
              wasDisplayOff = true;
+             display.clearLayer(LAYER_OVERLAY);
+             display.clearLayer(LAYER_HUD);
              display.clear();
              display.show(); 
         }
+        nextFrameAt = now + due;
+    }
+
+    // Bis zur nächsten Deadline schlafen, spätestens bis zum nächsten Netzwerk-Poll.
+    // requestFrame() aus einem anderen Task beendet den Schlaf vorzeitig.
+    long wait = (long)(nextFrameAt - millis());
+    // Freie Zeit bis dahin für vorgemerkte Icons nutzen, in Zeitscheiben wie die Downloads
+    if (iconManager.isPrefetching() && !frameRequested && wait > (long)PREFETCH_MIN_IDLE_MS) {
+        iconManager.processPrefetch(min((uint32_t)wait - PREFETCH_MIN_IDLE_MS, FETCH_SLICE_MS));
+        wait = (long)(nextFrameAt - millis());
     }
-    delay(1);
+    uint32_t sleepMs = wait <= 1 ? 1 : min((uint32_t)wait, iconManager.isFetching() ? FETCH_POLL_MS : NET_POLL_MS);
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));
 } 
 
 // --- NEU: Erweitertes und platzsparendes Gesundheits-Overlay ---
@@ -8,6 +8,7 @@
 #include "ConfigManager.h" 
 #include "DisplayManager.h"
 #include "SensorApp.h" 
+#include "IconManager.h"
 #include <time.h> 
 #include <esp_heap_caps.h> 
 #include "WeatherApp.h" 
@@ -18,8 +19,12 @@ extern void forceOverlay(String msg, int durationSec, String colorName);
 extern void queueAnimation(OverlayType animType, int durationSec); 
 // --- NEU: Globale Funktion für den MQTT Timer ---
 extern void triggerSysInfo(int durationSec);
+extern void requestBenchmark();
+extern void requestIconSoak(uint32_t loads, uint32_t cacheKb);
+extern void requestFrame();
 
 extern WeatherApp weatherApp;
+extern IconManager iconManager;
 
 #ifndef SPIRAM_ALLOCATOR_DEFINED
 #define SPIRAM_ALLOCATOR_DEFINED
@@ -56,6 +61,7 @@ private:
 
     void handleMqttMessage(char* topic, byte* payload, unsigned int length) {
         String t = String(topic);
+        requestFrame(); // Jede Nachricht kann das Bild ändern (App, Helligkeit, Sensordaten)
         
         SpiRamJsonDocument* doc = new SpiRamJsonDocument(8192);
         DeserializationError error = deserializeJson(*doc, payload, length);
@@ -78,6 +84,8 @@ private:
                  triggerSysInfo(300); // 5 Minuten Fallback
                  Serial.println("MQTT: SysInfo Overlay triggered (Text Payload)");
              }
+             if (t == "matrix/cmd/benchmark") requestBenchmark();
+             if (t == "matrix/cmd/icon_soak") requestIconSoak(2000, 48);
              delete doc;
              return;
         }
@@ -113,6 +121,7 @@ private:
              Serial.print("MQTT Overlay: "); Serial.println(msg);
              
              if (msg.length() > 0) {
+                 iconManager.prefetchText(msg);   // Icons laden, solange das Overlay noch in der Warteschlange steht
                  if (urgent) {
                      forceOverlay(msg, dur, col);
                  } else {
@@ -134,6 +143,9 @@ private:
             Serial.println("MQTT: SysInfo Overlay triggered (JSON Payload)");
         }
         
+        if (t == "matrix/cmd/benchmark") requestBenchmark();
+        if (t == "matrix/cmd/icon_soak") requestIconSoak((*doc)["loads"] | 2000, (*doc)["cache_kb"] | 48);
+        
         if (t == "matrix/cmd/sensor_page") {
             String id = (*doc)["id"] | "default";
             String title = (*doc)["title"] | "INFO";
@@ -147,6 +159,8 @@ private:
                 si.icon = item["icon"] | "";
                 si.text = item["text"] | "--"; 
                 si.color = item["color"] | "white";
+                iconManager.prefetchTag(si.icon);
+                iconManager.prefetchText(si.text);
                 items.push_back(si);
             }
             if (!items.empty()) sensorAppRef.updatePage(id, title, ttl, prio, items);
@@ -244,6 +258,7 @@ public:
 
         ArduinoOTA.onStart([this]() { 
             displayRef.setAppFade(1.0);
+            displayRef.endIndexed();
             displayRef.clear();
             displayRef.setTextColor(displayRef.color565(255, 255, 0)); 
             displayRef.printCentered("UPDATE", 32);
@@ -353,6 +368,11 @@ public:
         }
     }
 
+    void publish(const char* topic, const String& payload, bool retained = false) {
+        if (!client.connected()) return;
+        client.publish(topic, payload.c_str(), retained);
+    }
+
     void publishState() {
         if (!client.connected()) return;
         if (brightnessRef > 0) client.publish("matrix/status", "ON", true);
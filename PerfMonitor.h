@@ -0,0 +1,126 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// --- Frame-Telemetrie ---
+// Misst die Stufen eines Frames (App-draw pro App, Overlay, Debug-HUD, show) in µs.
+// Pro Stufe ein festes Histogramm mit logarithmischen Buckets (4 pro Zweierpotenz, bis ~1 s),
+// dazu Min/Max/Summe. Ein Messpunkt kostet zwei micros() und ein paar Integer-Operationen,
+// die Messung bleibt deshalb auch im Normalbetrieb aktiv.
+// Alle PERF_WINDOW_MS wird das Fenster als JSON abgeschlossen (MQTT matrix/status/perf, /perf).
+enum PerfStage { PERF_OVERLAY, PERF_HUD, PERF_SHOW, PERF_STAGE_COUNT };
+
+#define PERF_WINDOW_MS 10000
+
+class PerfMonitor {
+private:
+    static const int SUB = 4;               // Buckets pro Zweierpotenz
+    static const int BUCKETS = 20 * SUB;    // 1 µs .. ~1 s
+    static const int APP_COUNT = OFF;       // Alle echten Apps aus AppMode (vor OFF)
+
+    struct Histogram {
+        uint16_t buckets[BUCKETS];
+        uint32_t count;
+        uint32_t sum;
+        uint32_t minUs;
+        uint32_t maxUs;
+
+        void reset() {
+            memset(buckets, 0, sizeof(buckets));
+            count = 0; sum = 0; minUs = UINT32_MAX; maxUs = 0;
+        }
+    };
+
+    Histogram apps[APP_COUNT];
+    Histogram stages[PERF_STAGE_COUNT];
+    unsigned long windowStart = 0;
+    String lastReport = "{}";
+
+    // Bucket = 4 * floor(log2(us)) + die zwei Bits nach der führenden Eins
+    static int bucketFor(uint32_t us) {
+        if (us < SUB) return us;
+        int msb = 31 - __builtin_clz(us);
+        int b = msb * SUB + ((us >> (msb - 2)) & (SUB - 1));
+        return b < BUCKETS ? b : BUCKETS - 1;
+    }
+
+    // Obere Grenze eines Buckets in µs (p95 wird also leicht nach oben gerundet)
+    static uint32_t bucketLimit(int b) {
+        if (b < SUB) return b;
+        int msb = b / SUB;
+        return ((uint32_t)(SUB + (b % SUB) + 1) << (msb - 2)) - 1;
+    }
+
+    static void add(Histogram& h, uint32_t us) {
+        int b = bucketFor(us);
+        if (h.buckets[b] < UINT16_MAX) h.buckets[b]++;
+        h.count++;
+        h.sum += us;
+        if (us < h.minUs) h.minUs = us;
+        if (us > h.maxUs) h.maxUs = us;
+    }
+
+    static uint32_t percentile(const Histogram& h, uint8_t pct) {
+        uint32_t target = (h.count * pct + 99) / 100;
+        uint32_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += h.buckets[b];
+            if (seen >= target) return min(bucketLimit(b), h.maxUs);
+        }
+        return h.maxUs;
+    }
+
+    static void appendStats(String& out, const char* name, const Histogram& h) {
+        char buf[112];
+        snprintf(buf, sizeof(buf), "\"%s\":{\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"p95\":%lu,\"max\":%lu}",
+                 name, (unsigned long)h.count, (unsigned long)h.minUs, (unsigned long)(h.sum / h.count),
+                 (unsigned long)percentile(h, 95), (unsigned long)h.maxUs);
+        out += buf;
+    }
+
+public:
+    static const char* appName(int app) {
+        static const char* const names[] = {"wordclock", "sensors", "testpattern", "ticker", "plasma", "weather", "pong"};
+        return (app >= 0 && app < APP_COUNT) ? names[app] : "off";
+    }
+
+    PerfMonitor() { reset(); }
+
+    void reset() {
+        for (int i = 0; i < APP_COUNT; i++) apps[i].reset();
+        for (int i = 0; i < PERF_STAGE_COUNT; i++) stages[i].reset();
+        windowStart = millis();
+    }
+
+    void addApp(AppMode app, uint32_t us) {
+        if (app >= 0 && app < APP_COUNT) add(apps[app], us);
+    }
+
+    void addStage(PerfStage stage, uint32_t us) { add(stages[stage], us); }
+
+    // True, wenn ein Fenster abgeschlossen wurde; der Bericht liegt dann in getReport()
+    bool update(unsigned long now) {
+        if (now - windowStart < PERF_WINDOW_MS) return false;
+        String out = "{\"window_ms\":" + String(now - windowStart) + ",\"apps\":{";
+        bool first = true;
+        for (int i = 0; i < APP_COUNT; i++) {
+            if (!apps[i].count) continue;
+            if (!first) out += ",";
+            appendStats(out, appName(i), apps[i]);
+            first = false;
+        }
+        out += "}";
+        static const char* const stageNames[PERF_STAGE_COUNT] = {"overlay", "hud", "show"};
+        for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+            if (!stages[i].count) continue;
+            out += ",";
+            appendStats(out, stageNames[i], stages[i]);
+        }
+        out += "}";
+        lastReport = out;
+        reset();
+        return true;
+    }
+
+    const String& getReport() { return lastReport; }
+};
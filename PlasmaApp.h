@@ -9,6 +9,7 @@ private:
     int timePos1 = 0;
     int timePos2 = 0;
     unsigned long activeSince = 0; // <--- NEU
+    bool indexed = true;
 
 public:
     PlasmaApp() {}
@@ -33,9 +34,11 @@ public:
         paletteReady = true;
     }
 
-    bool draw(DisplayManager& display, bool force) override {
-        display.clear(); // Safety clear
+    // Indizierter Modus: 1 Byte pro Pixel, Palette und Fade löst der Compositor auf.
+    // false = alter Weg über drawPixel mit RGB565 (für den Benchmark-Vergleich).
+    void setIndexed(bool on) { indexed = on; }
 
+    bool draw(DisplayManager& display, bool force) override {
         static bool initialized = false;
         if (!initialized) {
             for (int i = 0; i < 256; i++) {
@@ -48,17 +51,28 @@ public:
         timePos1 += 2; 
         timePos2 += 3;
 
+        uint8_t* idx = indexed ? display.beginIndexed() : nullptr;
+        if (!idx) {
+            display.endIndexed();
+            display.clear(); // Safety clear
+        } else {
+            display.setPalette(palette);
+        }
+
         for (int y = 0; y < M_HEIGHT; y++) {
             uint8_t yBase = sinLUT[(y + timePos1) & 255];
             uint8_t yBase2 = sinLUT[(y * 2 + timePos2) & 255];
+            uint8_t* row = idx ? idx + y * M_WIDTH : nullptr;
 
             for (int x = 0; x < M_WIDTH; x++) {
                 uint8_t xVal = sinLUT[(x + timePos2) & 255];
                 uint8_t xyVal = sinLUT[(x + y + timePos1) & 255];
                 uint8_t total = (yBase + yBase2 + xVal + xyVal) / 2; 
-                display.drawPixel(x, y, palette[total]);
+                if (row) row[x] = total;
+                else display.drawPixel(x, y, palette[total]);
             }
         }
+        if (idx) display.markIndexedDirty();
         return true;
     }
-};
\ No newline at end of file
+};
@@ -1,50 +1,19 @@
 #pragma once
 #include "DisplayManager.h"
 #include "IconManager.h" 
+#include "RichTextTables.h"
 #include <map>
+#include <vector>
 
 // Zugriff auf globale Instanz
 extern IconManager iconManager;
 
-// --- FARBEN ---
-#define COL_WHITE      0xFFFF
-#define COL_BLACK      0x0000
-#define COL_RED        0xF800
-#define COL_GREEN      0x07E0
-#define COL_BLUE       0x001F
-#define COL_YELLOW     0xFFE0
-
-#define COL_HIGHLIGHT  0xFD20 
-#define COL_WARN       0xF800 
-#define COL_SUCCESS    0x07E0 
-#define COL_INFO       0x03EF 
-#define COL_MUTED      0x8410 
-#define COL_WARM       0xFE60 
-#define COL_COLD       0x841F 
-
-#define COL_GOLD       0xFEA0 
-#define COL_SILVER     0x9492 
-
-#define COL_NEON_PINK   0xF81F  
-#define COL_NEON_CYAN   0x07FF  
-#define COL_NEON_GREEN  0x07E0  
-#define COL_PURPLE      0x780F  
-#define COL_ORANGE      0xFD20  
-#define COL_MAGENTA     0xF81F  
-
-#define COL_SOFT_ROSE     0xFDB8  
-#define COL_SOFT_SKY      0x867D  
-#define COL_SOFT_MINT     0x9FF3  
-#define COL_SOFT_LAVENDER 0xE73F  
-#define COL_SOFT_PEACH    0xFED6  
-#define COL_SOFT_LEMON    0xFFF4  
-
-struct FontPair {
-    const uint8_t* regular;
-    const uint8_t* bold;
-    int8_t iconOffsetY;  
-    uint8_t lineHeight;
-    uint8_t baselineOffset; 
+// Fontname oder Handle. Literale wie "Medium" werden über richFontId() aufgelöst, ohne String anzulegen.
+struct RichFont {
+    RichFontId id;
+    constexpr RichFont(RichFontId i) : id(i) {}
+    constexpr RichFont(const char* name) : id(richFontId(name)) {}
+    RichFont(const String& name) : id(richFontId(name.c_str())) {}
 };
 
 struct RenderState {
@@ -53,119 +22,107 @@ struct RenderState {
     bool underlined;
 };
 
+// --- Vorkompilierte Display-Liste ---
+enum RichSpanKind : uint8_t { SPAN_TEXT, SPAN_SYMBOL, SPAN_ICON, SPAN_ANIM };
+
+struct RichSpan {
+    RichSpanKind kind;
+    bool underlined;
+    bool upscale;          // SPAN_ICON: LaMetric 8x8 -> 16x16
+    uint16_t color;
+    const uint8_t* font;   // SPAN_TEXT / SPAN_SYMBOL
+    uint16_t textOffset;   // UTF-8 Glyphen in RichTextList::glyphs (0-terminiert)
+    uint16_t iconIndex;    // SPAN_ICON / SPAN_ANIM: Name in RichTextList::icons
+    int16_t yOffset;       // Versatz zur Grundlinie
+    int16_t width;         // Cursor-Vorschub (inkl. Abstand nach Icons)
+};
+
+// Sichtbarer Bereich für das Abspielen. Spans komplett außerhalb werden übersprungen,
+// angeschnittene Spans normal gezeichnet (das Pixel-Clipping übernimmt die Canvas).
+struct RichClip {
+    int16_t x = 0, y = 0, w = M_WIDTH, h = M_HEIGHT;
+};
+
+// Ergebnis von RichText::compile(). Nach dem Kompilieren unveränderlich; das Abspielen
+// per RichText::draw() legt keine Objekte an.
+struct RichTextList {
+    std::vector<RichSpan> spans;
+    std::vector<char> glyphs;
+    std::vector<String> icons;  // Icon-Namen ohne Präfix (Schlüssel im IconManager-Cache)
+    mutable std::vector<IconHandle> handles;  // Parallel zu icons, wird beim Zeichnen nachgeführt
+    int width = 0;
+    uint8_t lineHeight = 0;
+    uint8_t baselineOffset = 0;
+
+    void clear() { spans.clear(); glyphs.clear(); icons.clear(); handles.clear(); width = 0; }
+    bool empty() const { return spans.empty(); }
+};
+
 class RichText {
 private:
     const uint8_t* iconFont = u8g2_font_unifont_t_symbols;
 
-    FontPair getFontByName(const String& name) {
-        if (name.equalsIgnoreCase("Small")) return { u8g2_font_helvR10_tf, u8g2_font_helvB10_tf, -1, 14, 11 };
-        if (name.equalsIgnoreCase("Medium")) return { u8g2_font_helvR12_tf, u8g2_font_helvB12_tf, -2, 16, 13 };
-        if (name.equalsIgnoreCase("Large")) return { u8g2_font_helvR18_tf, u8g2_font_helvB18_tf, -4, 24, 19 };
-        return { u8g2_font_helvR12_tf, u8g2_font_helvB12_tf, -2, 16, 13 };
-    }
+    const FontPair& getFont(RichFont font) { return RICH_FONTS[font.id < FONT_COUNT ? font.id : FONT_MEDIUM]; }
 
-    uint16_t parseHexColor(DisplayManager& d, const String& hex) {
-        // OPTIMIERUNG: Keine Kopie/Modification des Strings, direkter Zugriff via C-Pointer
-        const char* hexStr = hex.c_str();
+    uint16_t parseHexColor(DisplayManager& d, const char* hexStr) {
         if (hexStr[0] == '#') hexStr++; 
         long number = strtol(hexStr, NULL, 16);
         return d.color565((number >> 16) & 0xFF, (number >> 8) & 0xFF, number & 0xFF);
     }
 
-    String getIconCode(const String& name) {
-        if (name == "sun")      return "\u2600";
-        if (name == "cloud")    return "\u2601";
-        if (name == "rain")     return "\u2602";
-        if (name == "snow")     return "\u2603";
-        if (name == "zap")      return "\u26A1";
-        if (name == "water")    return "\u2614";
-        if (name == "drop")     return "\u2614";
-        if (name == "co2")      return "\u2622";
-        if (name == "gas")      return "\u2622";
-        if (name == "bio")      return "\u2623";
-        if (name == "temp")     return "\u263C";
-        if (name == "flame")    return "\u263C";
-        if (name == "house")    return "\u2302";
-        if (name == "coffee")   return "\u2615";
-        if (name == "cup")      return "\u2615";
-        if (name == "music")    return "\u266B";
-        if (name == "heart")    return "\u2665";
-        if (name == "star")     return "\u2605";
-        if (name == "phone")      return "\u260E";
-        if (name == "smartphone") return "\u260E";
-        if (name == "print")      return "\u2709";
-        if (name == "printer")    return "\u2709";
-        if (name == "bulb")       return "\u25CF";
-        if (name == "light")      return "\u263C";
-        if (name == "wifi")       return "\u260E";
-        if (name == "power")      return "\u23E9";
-        if (name == "car")        return "\u2638";
-        if (name == "battery")    return "\u25A4";
-        if (name == "gear")       return "\u2699";
-        if (name == "switch")     return "\u2611";
-        if (name == "siren")      return "\u26A0";
-        if (name == "stopwatch")  return "\u231B";
-        if (name == "man")      return "\u2642";
-        if (name == "woman")    return "\u2640";
-        if (name == "person")   return "\u265F";
-        if (name == "smile")    return "\u263A";
-        if (name == "arrow_u")  return "\u2191"; 
-        if (name == "arrow_d")  return "\u2193"; 
-        if (name == "arrow_l")  return "\u2190"; 
-        if (name == "arrow_r")  return "\u2192"; 
-        if (name == "check")    return "\u2713"; 
-        return "?"; 
-    }
+    // Text-Icon als UTF-8 (Binärsuche in RICH_ICONS, siehe RichTextTables.h)
+    const char* getIconCode(const char* name) { return richIconCode(name); }
 
-    String processTag(DisplayManager& d, const String& tag, RenderState& state, bool& isIcon, bool& isBitmapIcon, String& bitmapName, bool& isLametric, bool& isAnimated) {
+    // Wertet ein Tag (ohne Klammern) aus. Rückgabe: UTF-8 Text-Icon oder "" (zeigt in eine konstante Tabelle)
+    const char* processTag(DisplayManager& d, const char* tag, RenderState& state, bool& isIcon, bool& isBitmapIcon, String& bitmapName, bool& isLametric, bool& isAnimated) {
         isIcon = false;
         isBitmapIcon = false;
         isLametric = false;
         isAnimated = false;
         bitmapName = "";
 
-        if (tag == "b") { state.bold = !state.bold; return ""; }
-        if (tag == "u") { state.underlined = !state.underlined; return ""; }
-        if (tag.startsWith("c:")) { 
-            state.color = getColorByName(d, tag.substring(2)); 
+        if (strcmp(tag, "b") == 0) { state.bold = !state.bold; return ""; }
+        if (strcmp(tag, "u") == 0) { state.underlined = !state.underlined; return ""; }
+        if (strncmp(tag, "c:", 2) == 0) { 
+            state.color = getColorByName(d, tag + 2); 
             return ""; 
         }
 
-        if (tag.startsWith("ti:")) {
+        if (strncmp(tag, "ti:", 3) == 0) {
             isIcon = true;
-            return getIconCode(tag.substring(3));
+            return getIconCode(tag + 3);
         }
 
-        if (tag.startsWith("ic:")) {
+        if (strncmp(tag, "ic:", 3) == 0) {
             isBitmapIcon = true;
             isLametric = false; 
-            bitmapName = tag.substring(3);
+            bitmapName = tag + 3;
             return "";
         }
 
-        if (tag.startsWith("ln:")) {
+        if (strncmp(tag, "ln:", 3) == 0) {
             isBitmapIcon = true;
             isLametric = true; 
-            bitmapName = tag.substring(3);
+            bitmapName = tag + 3;
             return "";
         }
 
-        if (tag.startsWith("la:")) {
+        if (strncmp(tag, "la:", 3) == 0) {
             isBitmapIcon = true;
             isAnimated = true; 
-            bitmapName = tag.substring(3);
+            bitmapName = tag + 3;
             return "";
         }
 
-        if (tag.startsWith("an:")) {
+        if (strncmp(tag, "an:", 3) == 0) {
             isBitmapIcon = true;
             isAnimated = true; 
-            bitmapName = tag.substring(3);
+            bitmapName = tag + 3;
             return "";
         }
 
-        if (tag.startsWith("lt:")) {
-            String alias = tag.substring(3);
+        if (strncmp(tag, "lt:", 3) == 0) {
+            String alias = tag + 3;
             String id = iconManager.resolveAlias(alias);
             if (id != "") {
                 isBitmapIcon = true;
@@ -179,31 +136,30 @@ private:
         return getIconCode(tag);
     }
 
-    int drawPart(DisplayManager& d, int x, int y, const String& text, bool isIcon, bool isBitmapIcon, const String& bitmapName, bool isLametric, bool isAnimated, FontPair fonts, RenderState state) {
+    // Icon wird vorher einmal aufgelöst (anim bzw. icon), Messen und Zeichnen teilen sich den Zeiger
+    static int bitmapWidth(AnimatedIcon* anim, CachedIcon* icon, bool isLametric) {
+        if (anim) return IconManager::animWidth(anim) + 1;
+        int displayW = isLametric ? 16 : IconManager::iconWidth(icon);
+        return displayW + 1;
+    }
+
+    void drawBitmap(DisplayManager& d, int x, int y, AnimatedIcon* anim, CachedIcon* icon, bool isLametric, const FontPair& fonts) {
+        if (anim) {
+            int displayH = 16; 
+            int yCentered = y - (fonts.baselineOffset / 2) - (displayH / 2);
+            iconManager.drawAnimatedIcon(d, x, yCentered, anim);
+            return;
+        }
+        bool doUpscale = isLametric; 
+        int displayH = doUpscale ? 16 : IconManager::iconHeight(icon);
+        int yCentered = y - (fonts.baselineOffset / 2) - (displayH / 2);
+        iconManager.drawIcon(d, x, yCentered, icon, doUpscale);
+    }
+
+    int drawPart(DisplayManager& d, int x, int y, const String& text, bool isIcon, FontPair fonts, RenderState state) {
         d.setTextColor(state.color);
         
-        if (isBitmapIcon) {
-            if (isAnimated) {
-                int displayH = 16; 
-                int yCentered = y - (fonts.baselineOffset / 2) - (displayH / 2);
-                iconManager.drawAnimatedIcon(d, x, yCentered, bitmapName);
-                int displayW = iconManager.getAnimWidth(bitmapName);
-                return displayW + 1; 
-            } else {
-                bool doUpscale = isLametric; 
-                int iconH = iconManager.getIconHeight(bitmapName);
-                int displayH = doUpscale ? 16 : iconH;
-                int yCentered = y - (fonts.baselineOffset / 2) - (displayH / 2);
-                
-                iconManager.drawIcon(d, x, yCentered, bitmapName, doUpscale);
-                
-                int iconW = iconManager.getIconWidth(bitmapName);
-                int displayW = doUpscale ? 16 : iconW;
-                
-                return displayW + 1; 
-            }
-        }
-        else if (isIcon) {
+        if (isIcon) {
             d.setU8g2Font(iconFont);
             d.drawString(x, y + fonts.iconOffsetY, text, state.color);
             return d.getTextWidth(text) + 1;
@@ -216,15 +172,7 @@ private:
         }
     }
 
-    int measurePart(DisplayManager& d, const String& text, bool isIcon, bool isBitmapIcon, const String& bitmapName, bool isLametric, bool isAnimated, FontPair fonts, bool bold) {
-        if (isBitmapIcon) {
-            if (isAnimated) {
-                 return iconManager.getAnimWidth(bitmapName) + 1;
-            }
-            int iconW = iconManager.getIconWidth(bitmapName);
-            int displayW = isLametric ? 16 : iconW;
-            return displayW + 1; 
-        }
+    int measurePart(DisplayManager& d, const String& text, bool isIcon, FontPair fonts, bool bold) {
         if (isIcon) {
             d.setU8g2Font(iconFont);
             return d.getTextWidth(text) + 1;
@@ -234,52 +182,79 @@ private:
         return d.getTextWidth(text);
     }
 
+    RichTextList scratch;
+
+    void addTextSpan(DisplayManager& d, RichTextList& out, const char* content, const uint8_t* font, bool isSymbol, const FontPair& fonts, const RenderState& state) {
+        size_t len = strlen(content);
+        if (len == 0) return;
+        RichSpan span = {};
+        span.kind = isSymbol ? SPAN_SYMBOL : SPAN_TEXT;
+        span.underlined = !isSymbol && state.underlined;
+        span.color = state.color;
+        span.font = font;
+        span.yOffset = isSymbol ? fonts.iconOffsetY : 0;
+        span.textOffset = out.glyphs.size();
+        out.glyphs.insert(out.glyphs.end(), content, content + len + 1);
+
+        d.setU8g2Font(font);
+        span.width = d.getTextWidth(content) + (isSymbol ? 1 : 0);
+        out.width += span.width;
+        out.spans.push_back(span);
+    }
+
+    void addIconSpan(RichTextList& out, const String& name, bool isLametric, bool isAnimated, const FontPair& fonts) {
+        RichSpan span = {};
+        span.kind = isAnimated ? SPAN_ANIM : SPAN_ICON;
+        span.upscale = isLametric;
+        span.iconIndex = out.icons.size();
+        out.icons.push_back(name);
+
+        // Einmal auflösen; das Handle spart beim Zeichnen die Namenssuche
+        IconHandle handle = 0;
+        int displayW, displayH;
+        if (isAnimated) {
+            displayW = IconManager::animWidth(iconManager.resolveAnim(name, handle));
+            displayH = 16;
+        } else {
+            CachedIcon* icon = iconManager.resolveIcon(name, handle);
+            displayW = isLametric ? 16 : IconManager::iconWidth(icon);
+            displayH = isLametric ? 16 : IconManager::iconHeight(icon);
+        }
+        out.handles.push_back(handle);
+        span.yOffset = -(fonts.baselineOffset / 2) - (displayH / 2);
+        span.width = displayW + 1;
+        out.width += span.width;
+        out.spans.push_back(span);
+    }
+
 public:
-    uint16_t getColorByName(DisplayManager& d, const String& name) {
-        if (name.startsWith("#")) return parseHexColor(d, name);
-        
-        if (name.equalsIgnoreCase("white"))   return COL_WHITE;
-        if (name.equalsIgnoreCase("red"))     return COL_RED;
-        if (name.equalsIgnoreCase("green"))   return COL_GREEN;
-        if (name.equalsIgnoreCase("blue"))    return COL_BLUE;
-        if (name.equalsIgnoreCase("yellow"))  return COL_YELLOW;
-        
-        if (name.equalsIgnoreCase("highlight")) return COL_HIGHLIGHT;
-        if (name.equalsIgnoreCase("warn"))      return COL_WARN;
-        if (name.equalsIgnoreCase("success"))   return COL_SUCCESS;
-        if (name.equalsIgnoreCase("info"))      return COL_INFO;
-        if (name.equalsIgnoreCase("muted"))     return COL_MUTED;
-        if (name.equalsIgnoreCase("warm"))      return COL_WARM;
-        if (name.equalsIgnoreCase("cold"))      return COL_COLD;
-        
-        if (name.equalsIgnoreCase("gold"))      return COL_GOLD;
-        if (name.equalsIgnoreCase("silver"))    return COL_SILVER;
-        
-        if (name.equalsIgnoreCase("pink"))      return COL_NEON_PINK;
-        if (name.equalsIgnoreCase("cyan"))      return COL_NEON_CYAN;
-        if (name.equalsIgnoreCase("lime"))      return COL_NEON_GREEN;
-        if (name.equalsIgnoreCase("purple"))    return COL_PURPLE;
-        if (name.equalsIgnoreCase("orange"))    return COL_ORANGE;
-        if (name.equalsIgnoreCase("magenta"))   return COL_MAGENTA;
-        
-        if (name.equalsIgnoreCase("rose"))      return COL_SOFT_ROSE;
-        if (name.equalsIgnoreCase("sky"))       return COL_SOFT_SKY;
-        if (name.equalsIgnoreCase("mint"))      return COL_SOFT_MINT;
-        if (name.equalsIgnoreCase("lavender"))  return COL_SOFT_LAVENDER;
-        if (name.equalsIgnoreCase("peach"))     return COL_SOFT_PEACH;
-        if (name.equalsIgnoreCase("lemon"))     return COL_SOFT_LEMON;
-
-        return COL_WHITE;
+    // Benannte Farbe (RICH_COLORS) oder "#RRGGBB", unbekannt = Weiß
+    uint16_t getColorByName(DisplayManager& d, const char* name) {
+        if (name[0] == '#') return parseHexColor(d, name);
+        return richColor(name);
     }
+    uint16_t getColorByName(DisplayManager& d, const String& name) { return getColorByName(d, name.c_str()); }
 
-    int getLineHeight(const String& fontName) { return getFontByName(fontName).lineHeight; }
+    int getLineHeight(RichFont font) { return getFont(font).lineHeight; }
     
-    int getBaselineOffset(const String& fontName) { return getFontByName(fontName).baselineOffset; }
+    int getBaselineOffset(RichFont font) { return getFont(font).baselineOffset; }
+
+    // --- Kompilieren & Abspielen ---
+    // Zerlegt das Markup einmalig in Spans mit aufgelöster Farbe, Font, Icon und gemessener Breite.
+    RichTextList compile(DisplayManager& d, const String& text, RichFont font, uint16_t defaultColor = COL_WHITE) {
+        RichTextList list;
+        compileInto(d, text, font, list, defaultColor);
+        return list;
+    }
+
+    // Wie compile(), verwendet aber die Puffer einer bestehenden Liste weiter
+    void compileInto(DisplayManager& d, const String& text, RichFont font, RichTextList& out, uint16_t defaultColor = COL_WHITE) {
+        const FontPair& fonts = getFont(font);
+        RenderState state = {defaultColor, false, false};
+        out.clear();
+        out.lineHeight = fonts.lineHeight;
+        out.baselineOffset = fonts.baselineOffset;
 
-    int getTextWidth(DisplayManager& d, const String& text, const String& fontName) {
-        FontPair fonts = getFontByName(fontName);
-        int totalW = 0;
-        RenderState state = {COL_WHITE, false, false};
         unsigned int len = text.length();
         unsigned int i = 0;
         while(i < len) {
@@ -291,60 +266,74 @@ public:
                 bool isIcon, isBitmapIcon, isLametric, isAnimated;
                 String bitmapName;
                 
-                String content = processTag(d, tag, state, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated);
-                
-                if(isIcon || isBitmapIcon) {
-                    totalW += measurePart(d, content, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated, fonts, state.bold);
-                }
+                const char* content = processTag(d, tag.c_str(), state, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated);
+                if (isBitmapIcon) addIconSpan(out, bitmapName, isLametric, isAnimated, fonts);
+                else if (isIcon && content[0]) addTextSpan(d, out, content, iconFont, true, fonts, state);
                 i = end + 1;
             } else {
                 int nextTag = text.indexOf('{', i);
                 if(nextTag == -1) nextTag = len;
-                String part = text.substring(i, nextTag);
-                totalW += measurePart(d, part, false, false, "", false, false, fonts, state.bold);
+                addTextSpan(d, out, text.substring(i, nextTag).c_str(), state.bold ? fonts.bold : fonts.regular, false, fonts, state);
                 i = nextTag;
             }
         }
-        return totalW;
     }
 
-    void drawCentered(DisplayManager& d, int y, const String& text, const String& fontName, uint16_t defaultColor = COL_WHITE) {
-        int totalW = getTextWidth(d, text, fontName);
-        drawString(d, (M_WIDTH - totalW) / 2, y, text, fontName, defaultColor);
-    }
+    // Spielt eine kompilierte Liste ab (x = linker Rand, y = Grundlinie). Unsichtbare Spans kosten
+    // nur eine Addition, ab dem rechten Rand des Clip-Bereichs wird abgebrochen.
+    void draw(DisplayManager& d, int x, int y, const RichTextList& list, const RichClip& clip = RichClip()) {
+        const int slack = 2; // Glyphen dürfen minimal über ihre gemessene Breite hinausragen
+        int lineTop = y - list.baselineOffset - slack;
+        int lineBottom = y - list.baselineOffset + list.lineHeight + slack;
+        if (lineBottom <= clip.y || lineTop >= clip.y + clip.h) return;
 
-    void drawString(DisplayManager& d, int x, int y, const String& text, const String& fontName, uint16_t defaultColor = COL_WHITE) {
-        FontPair fonts = getFontByName(fontName);
-        RenderState state = {defaultColor, false, false};
+        int clipL = clip.x - slack, clipR = clip.x + clip.w + slack;
         int cursorX = x;
-        unsigned int len = text.length();
-        unsigned int i = 0;
-        while(i < len) {
-            if(text[i] == '{') {
-                int end = text.indexOf('}', i);
-                if(end == -1) break;
-                String tag = text.substring(i+1, end);
-                
-                bool isIcon, isBitmapIcon, isLametric, isAnimated;
-                String bitmapName;
-                
-                String content = processTag(d, tag, state, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated);
-                if(content != "" || isBitmapIcon) {
-                     cursorX += drawPart(d, cursorX, y, content, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated, fonts, state);
-                }
-                i = end + 1;
-            } else {
-                int nextTag = text.indexOf('{', i);
-                if(nextTag == -1) nextTag = len;
-                String part = text.substring(i, nextTag);
-                cursorX += drawPart(d, cursorX, y, part, false, false, "", false, false, fonts, state);
-                i = nextTag;
+        for (const RichSpan& span : list.spans) {
+            if (cursorX >= clipR) break;
+            if (cursorX + span.width <= clipL) { cursorX += span.width; continue; }
+            switch (span.kind) {
+                case SPAN_TEXT:
+                case SPAN_SYMBOL:
+                    d.setU8g2Font(span.font);
+                    d.drawText(cursorX, y + span.yOffset, list.glyphs.data() + span.textOffset, span.color);
+                    if (span.underlined) d.drawFastHLine(cursorX, y + 2, span.width, span.color);
+                    break;
+                case SPAN_ICON:
+                    iconManager.drawIcon(d, cursorX, y + span.yOffset,
+                                         iconManager.resolveIcon(list.icons[span.iconIndex], list.handles[span.iconIndex]), span.upscale);
+                    break;
+                case SPAN_ANIM:
+                    iconManager.drawAnimatedIcon(d, cursorX, y + span.yOffset,
+                                                 iconManager.resolveAnim(list.icons[span.iconIndex], list.handles[span.iconIndex]));
+                    break;
             }
+            cursorX += span.width;
         }
     }
+
+    void drawCentered(DisplayManager& d, int y, const RichTextList& list, const RichClip& clip = RichClip()) {
+        draw(d, (M_WIDTH - list.width) / 2, y, list, clip);
+    }
+
+    // Bequeme Varianten für wechselnden Text: kompilieren in eine wiederverwendete Liste
+    int getTextWidth(DisplayManager& d, const String& text, RichFont font) {
+        compileInto(d, text, font, scratch);
+        return scratch.width;
+    }
+
+    void drawCentered(DisplayManager& d, int y, const String& text, RichFont font, uint16_t defaultColor = COL_WHITE) {
+        compileInto(d, text, font, scratch, defaultColor);
+        drawCentered(d, y, scratch);
+    }
+
+    void drawString(DisplayManager& d, int x, int y, const String& text, RichFont font, uint16_t defaultColor = COL_WHITE) {
+        compileInto(d, text, font, scratch, defaultColor);
+        draw(d, x, y, scratch);
+    }
     
-    void drawBox(DisplayManager& d, int x, int y, int width, const String& text, const String& fontName, uint16_t defaultColor = COL_WHITE) {
-        FontPair fonts = getFontByName(fontName);
+    void drawBox(DisplayManager& d, int x, int y, int width, const String& text, RichFont font, uint16_t defaultColor = COL_WHITE) {
+        const FontPair& fonts = getFont(font);
         RenderState state = {defaultColor, false, false};
         int startX = x;
         int cursorX = x;
@@ -360,11 +349,19 @@ public:
                 bool isIcon, isBitmapIcon, isLametric, isAnimated;
                 String bitmapName;
 
-                String content = processTag(d, tag, state, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated);
-                if(isIcon || isBitmapIcon) {
-                    int w = measurePart(d, content, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated, fonts, state.bold);
+                String content = processTag(d, tag.c_str(), state, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated);
+                if (isBitmapIcon) {
+                    // Genau eine Namenssuche pro Icon, der Zeiger bleibt bis zum Zeichnen gültig
+                    AnimatedIcon* anim = isAnimated ? iconManager.getAnimatedIcon(bitmapName) : nullptr;
+                    CachedIcon* icon = isAnimated ? nullptr : iconManager.getIcon(bitmapName);
+                    int w = bitmapWidth(anim, icon, isLametric);
+                    if (cursorX + w > startX + width) { cursorX = startX; cursorY += fonts.lineHeight; }
+                    drawBitmap(d, cursorX, cursorY, anim, icon, isLametric, fonts);
+                    cursorX += w;
+                } else if (isIcon) {
+                    int w = measurePart(d, content, true, fonts, state.bold);
                     if (cursorX + w > startX + width) { cursorX = startX; cursorY += fonts.lineHeight; }
-                    drawPart(d, cursorX, cursorY, content, isIcon, isBitmapIcon, bitmapName, isLametric, isAnimated, fonts, state);
+                    drawPart(d, cursorX, cursorY, content, true, fonts, state);
                     cursorX += w;
                 }
                 i = end + 1;
@@ -377,13 +374,13 @@ public:
                 bool isSpace = (endOfWord == nextSpace);
                 String word = text.substring(i, endOfWord);
                 
-                int w = measurePart(d, word, false, false, "", false, false, fonts, state.bold);
+                int w = measurePart(d, word, false, fonts, state.bold);
                 if (cursorX + w > startX + width) { cursorX = startX; cursorY += fonts.lineHeight; }
-                drawPart(d, cursorX, cursorY, word, false, false, "", false, false, fonts, state);
+                drawPart(d, cursorX, cursorY, word, false, fonts, state);
                 cursorX += w;
                 
                 if (isSpace) {
-                     int spaceW = measurePart(d, " ", false, false, "", false, false, fonts, state.bold);
+                     int spaceW = measurePart(d, " ", false, fonts, state.bold);
                      if (cursorX + spaceW <= startX + width) cursorX += spaceW;
                      i = endOfWord + 1;
                 } else i = endOfWord;
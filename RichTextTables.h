@@ -0,0 +1,146 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <U8g2_for_Adafruit_GFX.h>
+
+// --- Nachschlagetabellen für RichText-Tags ---
+// Farbnamen, Text-Icons und Fontnamen liegen als sortierte constexpr-Arrays im Flash.
+// Gesucht wird binär; ist das Argument ein Literal, rechnet der Compiler das Ergebnis
+// schon beim Übersetzen aus (z.B. richColor("mint") in einem static_assert oder als Konstante).
+// Neue Einträge alphabetisch einsortieren, sonst schlägt der static_assert unten fehl.
+
+// --- FARBEN ---
+#define COL_WHITE      0xFFFF
+#define COL_BLACK      0x0000
+#define COL_RED        0xF800
+#define COL_GREEN      0x07E0
+#define COL_BLUE       0x001F
+#define COL_YELLOW     0xFFE0
+
+#define COL_HIGHLIGHT  0xFD20
+#define COL_WARN       0xF800
+#define COL_SUCCESS    0x07E0
+#define COL_INFO       0x03EF
+#define COL_MUTED      0x8410
+#define COL_WARM       0xFE60
+#define COL_COLD       0x841F
+
+#define COL_GOLD       0xFEA0
+#define COL_SILVER     0x9492
+
+#define COL_NEON_PINK   0xF81F
+#define COL_NEON_CYAN   0x07FF
+#define COL_NEON_GREEN  0x07E0
+#define COL_PURPLE      0x780F
+#define COL_ORANGE      0xFD20
+#define COL_MAGENTA     0xF81F
+
+#define COL_SOFT_ROSE     0xFDB8
+#define COL_SOFT_SKY      0x867D
+#define COL_SOFT_MINT     0x9FF3
+#define COL_SOFT_LAVENDER 0xE73F
+#define COL_SOFT_PEACH    0xFED6
+#define COL_SOFT_LEMON    0xFFF4
+
+struct FontPair {
+    const uint8_t* regular;
+    const uint8_t* bold;
+    int8_t iconOffsetY;
+    uint8_t lineHeight;
+    uint8_t baselineOffset;
+};
+
+struct RichColorEntry { const char* name; uint16_t color; };
+struct RichIconEntry { const char* name; const char* code; };
+
+// Handle statt Fontname: Index in RICH_FONTS
+enum RichFontId : uint8_t { FONT_LARGE, FONT_MEDIUM, FONT_SMALL, FONT_COUNT };
+struct RichFontEntry { const char* name; RichFontId id; };
+
+// Farbnamen ohne Beachtung der Groß-/Kleinschreibung, daher klein geschrieben
+static constexpr RichColorEntry RICH_COLORS[] = {
+    {"blue", COL_BLUE},              {"cold", COL_COLD},              {"cyan", COL_NEON_CYAN},
+    {"gold", COL_GOLD},              {"green", COL_GREEN},            {"highlight", COL_HIGHLIGHT},
+    {"info", COL_INFO},              {"lavender", COL_SOFT_LAVENDER}, {"lemon", COL_SOFT_LEMON},
+    {"lime", COL_NEON_GREEN},        {"magenta", COL_MAGENTA},        {"mint", COL_SOFT_MINT},
+    {"muted", COL_MUTED},            {"orange", COL_ORANGE},          {"peach", COL_SOFT_PEACH},
+    {"pink", COL_NEON_PINK},         {"purple", COL_PURPLE},          {"red", COL_RED},
+    {"rose", COL_SOFT_ROSE},         {"silver", COL_SILVER},          {"sky", COL_SOFT_SKY},
+    {"success", COL_SUCCESS},        {"warm", COL_WARM},              {"warn", COL_WARN},
+    {"white", COL_WHITE},            {"yellow", COL_YELLOW},
+};
+
+// Text-Icons aus u8g2_font_unifont_t_symbols (UTF-8), Groß-/Kleinschreibung wird beachtet
+static constexpr RichIconEntry RICH_ICONS[] = {
+    {"arrow_d", "\u2193"},   {"arrow_l", "\u2190"},   {"arrow_r", "\u2192"},   {"arrow_u", "\u2191"},
+    {"battery", "\u25A4"},   {"bio", "\u2623"},       {"bulb", "\u25CF"},      {"car", "\u2638"},
+    {"check", "\u2713"},     {"cloud", "\u2601"},     {"co2", "\u2622"},       {"coffee", "\u2615"},
+    {"cup", "\u2615"},       {"drop", "\u2614"},      {"flame", "\u263C"},     {"gas", "\u2622"},
+    {"gear", "\u2699"},      {"heart", "\u2665"},     {"house", "\u2302"},     {"light", "\u263C"},
+    {"man", "\u2642"},       {"music", "\u266B"},     {"person", "\u265F"},    {"phone", "\u260E"},
+    {"power", "\u23E9"},     {"print", "\u2709"},     {"printer", "\u2709"},   {"rain", "\u2602"},
+    {"siren", "\u26A0"},     {"smartphone", "\u260E"},{"smile", "\u263A"},     {"snow", "\u2603"},
+    {"star", "\u2605"},      {"stopwatch", "\u231B"}, {"sun", "\u2600"},       {"switch", "\u2611"},
+    {"temp", "\u263C"},      {"water", "\u2614"},     {"wifi", "\u260E"},      {"woman", "\u2640"},
+    {"zap", "\u26A1"},
+};
+
+static constexpr RichFontEntry RICH_FONT_NAMES[] = {
+    {"large", FONT_LARGE}, {"medium", FONT_MEDIUM}, {"small", FONT_SMALL},
+};
+
+// Reihenfolge wie RichFontId
+static constexpr FontPair RICH_FONTS[FONT_COUNT] = {
+    { u8g2_font_helvR18_tf, u8g2_font_helvB18_tf, -4, 24, 19 },
+    { u8g2_font_helvR12_tf, u8g2_font_helvB12_tf, -2, 16, 13 },
+    { u8g2_font_helvR10_tf, u8g2_font_helvB10_tf, -1, 14, 11 },
+};
+
+// --- Suche (C++11-constexpr: nur Rekursion, keine Schleifen) ---
+constexpr char richFold(char c, bool icase) { return (icase && c >= 'A' && c <= 'Z') ? (char)(c + 32) : c; }
+
+constexpr int richCompare(const char* a, const char* b, bool icase) {
+    return richFold(*a, icase) != richFold(*b, icase)
+        ? (int)(uint8_t)richFold(*a, icase) - (int)(uint8_t)richFold(*b, icase)
+        : (*a == 0 ? 0 : richCompare(a + 1, b + 1, icase));
+}
+
+template <typename T, size_t N>
+constexpr int richFind(const T (&table)[N], const char* key, bool icase, int lo = 0, int hi = (int)N - 1);
+
+template <typename T, size_t N>
+constexpr int richFindStep(const T (&table)[N], const char* key, bool icase, int lo, int hi, int mid, int cmp) {
+    return cmp == 0 ? mid : (cmp < 0 ? richFind(table, key, icase, lo, mid - 1) : richFind(table, key, icase, mid + 1, hi));
+}
+
+// Index des Eintrags oder -1
+template <typename T, size_t N>
+constexpr int richFind(const T (&table)[N], const char* key, bool icase, int lo, int hi) {
+    return (!key || lo > hi) ? -1 : richFindStep(table, key, icase, lo, hi, (lo + hi) / 2, richCompare(key, table[(lo + hi) / 2].name, icase));
+}
+
+template <typename T, size_t N>
+constexpr bool richSorted(const T (&table)[N], bool icase, size_t i = 1) {
+    return i >= N || (richCompare(table[i - 1].name, table[i].name, icase) < 0 && richSorted(table, icase, i + 1));
+}
+
+static_assert(richSorted(RICH_COLORS, true), "RICH_COLORS muss alphabetisch sortiert sein");
+static_assert(richSorted(RICH_ICONS, false), "RICH_ICONS muss alphabetisch sortiert sein");
+static_assert(richSorted(RICH_FONT_NAMES, true), "RICH_FONT_NAMES muss alphabetisch sortiert sein");
+
+// Benannte Farbe, unbekannt = fallback (Hex-Farben "#RRGGBB" löst RichText::getColorByName auf)
+constexpr uint16_t richColorAt(int i, uint16_t fallback) { return i < 0 ? fallback : RICH_COLORS[i].color; }
+constexpr uint16_t richColor(const char* name, uint16_t fallback = COL_WHITE) {
+    return richColorAt(richFind(RICH_COLORS, name, true), fallback);
+}
+
+// UTF-8 Code eines Text-Icons, unbekannt = "?"
+constexpr const char* richIconAt(int i) { return i < 0 ? "?" : RICH_ICONS[i].code; }
+constexpr const char* richIconCode(const char* name) { return richIconAt(richFind(RICH_ICONS, name, false)); }
+
+// Unbekannte Namen fallen auf Medium zurück
+constexpr RichFontId richFontAt(int i) { return i < 0 ? FONT_MEDIUM : RICH_FONT_NAMES[i].id; }
+constexpr RichFontId richFontId(const char* name) { return richFontAt(richFind(RICH_FONT_NAMES, name, true)); }
+
+static_assert(richColor("Mint") == COL_SOFT_MINT && richColor("nope") == COL_WHITE, "Farbtabelle");
+static_assert(richFontId("Large") == FONT_LARGE && richFontId("") == FONT_MEDIUM, "Fonttabelle");
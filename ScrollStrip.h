@@ -0,0 +1,130 @@
+#pragma once
+#include "DisplayManager.h"
+#include "IconManager.h"
+#include "RichText.h"
+#include <vector>
+
+extern IconManager iconManager;
+
+// --- Scroll-Strip für Lauftexte ---
+// Die kompilierte RichText-Zeile wird einmal in ein PSRAM-Band gerendert (Breite = Textbreite).
+// Pro Frame wird nur das sichtbare Fenster kopiert; animierte Icons werden im Band nachgepatcht,
+// sobald ihr Frame wechselt. Ist das Band größer als maxBytes, wird live über RichText gezeichnet.
+class ScrollStrip {
+private:
+    static const int PAD = 3;    // Luft über/unter der Zeile für Umlaute und 16px Icons
+    static size_t maxBytes;      // Obergrenze pro Strip (config.json: system.scroll_strip_max_kb)
+
+    struct AnimPatch {
+        int16_t x, y;            // Position im Strip
+        int16_t w;               // Breite des Spans
+        uint16_t iconIndex;      // Name in RichTextList::icons
+        int16_t lastFrame;
+    };
+
+    uint16_t* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    int baselineY = 0;           // Grundlinie innerhalb des Strips
+    bool live = false;
+    uint32_t builtGeneration = 0;  // IconManager::getIconGeneration() beim Rendern
+    std::vector<AnimPatch> anims;
+
+    void patchAnims(const RichTextList& list, int x, const RichClip& clip) {
+        for (AnimPatch& a : anims) {
+            int sx = x + a.x;
+            if (sx + a.w <= clip.x || sx >= clip.x + clip.w) continue;
+
+            AnimatedIcon* anim = iconManager.resolveAnim(list.icons[a.iconIndex], list.handles[a.iconIndex]);
+            if (!anim) continue;
+            int frame = iconManager.getAnimFrameIndex(anim);
+            if (frame == a.lastFrame) continue;
+            a.lastFrame = frame;
+
+            // Alten Frame entfernen, neuen Frame direkt in den Strip blitten
+            for (int row = max(0, (int)a.y); row < min(height, a.y + anim->height); row++) {
+                uint16_t* p = pixels + row * width;
+                for (int col = a.x; col < min(width, a.x + anim->width); col++) p[col] = LAYER_TRANSPARENT;
+            }
+            int16_t minX, maxX;
+            DisplayManager::blitRunsInto(pixels, width, height, a.x, a.y,
+                                         iconManager.getAnimFrame(anim, frame), anim->width, anim->height,
+                                         IconManager::animRuns(anim, frame), 1, minX, maxX);
+        }
+    }
+
+public:
+    static void setMaxBytes(size_t bytes) { maxBytes = bytes; }
+    static size_t getMaxBytes() { return maxBytes; }
+
+    ~ScrollStrip() { release(); }
+
+    // Rendert die Liste in den Strip. False = zu groß oder kein Speicher, draw() zeichnet dann live.
+    bool build(DisplayManager& d, RichText& rt, const RichTextList& list) {
+        release();
+        builtGeneration = iconManager.getIconGeneration();
+        width = list.width;
+        height = list.lineHeight + 2 * PAD;
+        baselineY = PAD + list.baselineOffset;
+
+        size_t bytes = (size_t)width * height * sizeof(uint16_t);
+        if (width <= 0 || height > M_HEIGHT || bytes > maxBytes) { live = true; return false; }
+
+        pixels = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        PSRAMCanvas16* scratch = pixels ? new PSRAMCanvas16(M_WIDTH, M_HEIGHT) : nullptr;
+        if (!pixels || !scratch || !scratch->getBuffer()) {
+            if (scratch) delete scratch;
+            release();
+            live = true;
+            return false;
+        }
+
+        // In Abschnitten von Panel-Breite über eine temporäre Canvas rendern
+        d.beginOffscreen(scratch);
+        for (int cx = 0; cx < width; cx += M_WIDTH) {
+            scratch->fillScreen(LAYER_TRANSPARENT);
+            rt.draw(d, -cx, baselineY, list);
+            int cw = min(M_WIDTH, width - cx);
+            const uint16_t* src = scratch->getBuffer();
+            for (int row = 0; row < height; row++) {
+                memcpy(pixels + row * width + cx, src + row * M_WIDTH, cw * sizeof(uint16_t));
+            }
+        }
+        d.endOffscreen();
+        delete scratch;
+
+        int ax = 0;
+        for (const RichSpan& span : list.spans) {
+            if (span.kind == SPAN_ANIM) anims.push_back({ (int16_t)ax, (int16_t)(baselineY + span.yOffset), span.width, span.iconIndex, -1 });
+            ax += span.width;
+        }
+        return true;
+    }
+
+    // Zeichnet das sichtbare Fenster (x = linker Rand des Textes, y = Grundlinie)
+    void draw(DisplayManager& d, RichText& rt, int x, int y, const RichTextList& list, const RichClip& clip = RichClip()) {
+        if (live || !pixels) { rt.draw(d, x, y, list, clip); return; }
+        // Ein nachgeladenes Icon ersetzt seinen Platzhalter (gleiche Breite, das Layout bleibt)
+        if (builtGeneration != iconManager.getIconGeneration() && !build(d, rt, list)) { rt.draw(d, x, y, list, clip); return; }
+        patchAnims(list, x, clip);
+
+        int top = y - baselineY;
+        int sx0 = max(0, clip.x - x), sx1 = min(width, clip.x + clip.w - x);
+        int sy0 = max(0, clip.y - top), sy1 = min(height, clip.y + clip.h - top);
+        if (sx0 >= sx1 || sy0 >= sy1) return;
+        d.blitRGB565Keyed(x + sx0, top + sy0, pixels + sy0 * width + sx0, width, sx1 - sx0, sy1 - sy0, LAYER_TRANSPARENT);
+    }
+
+    void release() {
+        if (pixels) heap_caps_free(pixels);
+        pixels = nullptr;
+        width = 0;
+        live = false;
+        anims.clear();
+    }
+
+    bool isLive() { return live; }
+    size_t getBytes() { return pixels ? (size_t)width * height * sizeof(uint16_t) : 0; }
+};
+
+size_t ScrollStrip::maxBytes = 96 * 1024;
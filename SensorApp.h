@@ -30,6 +30,7 @@ private:
     const int SWITCH_DELAY = 8000; 
 
     bool needsRedraw = true;
+    bool hasAnimation = false;  // Aktuelle Seite enthält ein animiertes Icon
     bool cycleComplete = false; // <--- NEU: Merker für Durchlauf
 
 public:
@@ -110,14 +111,7 @@ public:
         }
 
 // --- Dynamische Anzeigedauer berechnen ---
-        unsigned long currentDelay = SWITCH_DELAY;
-        if (currentPageIt != pages.end()) {
-            if (currentPageIt->second.priority == 1) {
-                currentDelay = SWITCH_DELAY * 2.0; // Prio 1: 100% länger (doppelte Zeit)
-            } else if (currentPageIt->second.priority == 2) {
-                currentDelay = SWITCH_DELAY * 1.5; // Prio 2: 50% länger
-            }
-        }
+        unsigned long currentDelay = getPageDelay();
 
         // 3. Seitenwechsel
         if (now - lastPageSwitch > currentDelay) {
@@ -145,7 +139,7 @@ public:
         // --- NEU: Animations-Check ---
         // Wir prüfen, ob die aktuell angezeigte Seite ein animiertes Icon ("la:") enthält.
         // --- NEU: Animations-Check ---
-        bool hasAnimation = false;
+        hasAnimation = false;
         if (currentPageIt != pages.end()) {
             for (const auto& item : currentPageIt->second.items) {
                 // NEU: Reagiert jetzt auch auf das "an:" Präfix!
@@ -201,7 +195,28 @@ public:
         return true;
     }
 
+    // Ohne Animation nur zum Seitenwechsel aufwachen; TTL wird spätestens nach IDLE_FRAME_MS geprüft
+    uint32_t nextFrameDueMs(unsigned long now) override {
+        if (needsRedraw) return 0;
+        if (hasAnimation) return FRAME_INTERVAL_MS;
+        unsigned long elapsed = now - lastPageSwitch;
+        unsigned long delay = getPageDelay();
+        return elapsed > delay ? IDLE_FRAME_MS : min((unsigned long)IDLE_FRAME_MS, delay - elapsed + 1);
+    }
+
 private:
+    unsigned long getPageDelay() {
+        unsigned long currentDelay = SWITCH_DELAY;
+        if (currentPageIt != pages.end()) {
+            if (currentPageIt->second.priority == 1) {
+                currentDelay = SWITCH_DELAY * 2.0; // Prio 1: 100% länger (doppelte Zeit)
+            } else if (currentPageIt->second.priority == 2) {
+                currentDelay = SWITCH_DELAY * 1.5; // Prio 2: 50% länger
+            }
+        }
+        return currentDelay;
+    }
+
     void drawPage(DisplayManager& display, SensorPage& p) {
         richText.drawCentered(display, 12, "{c:peach}" + p.title, "Small");
         display.drawFastHLine(0, 15, M_WIDTH, display.color565(50, 50, 50));
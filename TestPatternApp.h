@@ -19,4 +19,7 @@ public:
         }
         return true;
     }
+
+    // Statisches Bild
+    uint32_t nextFrameDueMs(unsigned long now) override { return IDLE_FRAME_MS; }
 };
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 #include "App.h"
 #include "RichText.h"
+#include "ScrollStrip.h"
 
 class TickerApp : public App {
 private:
     RichText richText;
     String message = "{c:mint}Matrix OS RichTextEngine:{c:white}  Font Icons: {sun}{star}{arrow_u}  Bitmap Icons PNG: {ic:grinning_face}{ic:cowboy_hat_face}{ic:clown_face}  LaMetric Static: {ln:8441}  Animated: {la:61}";
+    RichTextList compiled;  // Einmal kompiliert ...
+    ScrollStrip strip;      // ... und einmal vorgerendert, jeden Frame nur das Fenster kopiert
     int scrollX = M_WIDTH;
     int totalWidth = -1;
     unsigned long lastScrollTime = 0;
@@ -16,12 +19,14 @@ public:
         display.clear(); // Ticker muss immer clean sein
 
         if (totalWidth == -1) {
-            totalWidth = richText.getTextWidth(display, message, "Medium");
+            richText.compileInto(display, message, "Medium", compiled);
+            totalWidth = compiled.width;
+            strip.build(display, richText, compiled);
             scrollX = M_WIDTH;
             lastScrollTime = millis();
         }
 
-        richText.drawString(display, scrollX, 38, message, "Medium");
+        strip.draw(display, richText, scrollX, 38, compiled);
 
         if (millis() - lastScrollTime >= scrollDelay) {
             scrollX--; 
@@ -33,6 +38,12 @@ public:
         return true; // Immer Update nötig
     }
     
+    uint32_t nextFrameDueMs(unsigned long now) override {
+        if (totalWidth == -1) return 0;
+        unsigned long elapsed = now - lastScrollTime;
+        return elapsed >= (unsigned long)scrollDelay ? 0 : scrollDelay - elapsed;
+    }
+    
     void setMessage(String msg) {
         message = msg;
         totalWidth = -1; 
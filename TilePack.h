@@ -0,0 +1,185 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "DisplayManager.h"
+
+// --- Tile-Pack (.tpk): Icon-Sheet im Ladeformat des IconManagers ---
+// Aufbau (little endian):
+//   TilePackHeader  16 Byte
+//   Offsets         (count + 1) * uint32_t ab Dateianfang, Kachel i liegt in [off[i], off[i+1])
+//   Kacheln         tileW * tileH RGB565-Pixel, direkt danach die Run-Maske (DisplayManager::buildRunMask).
+//                   Komplett transparente Kacheln belegen 0 Byte (off[i] == off[i+1]).
+// Die Offset-Tabelle wird beim Öffnen einmal gelesen, danach kostet eine Kachel ein seek + ein read
+// direkt in den Cache-Block. Erzeugt wird das Pack vom IconManager aus dem BMP/PNG-Sheet (buildTilePack).
+struct TilePackHeader {
+    char magic[4];          // "MTPK"
+    uint8_t version;
+    uint8_t alphaThreshold; // Schwelle, mit der die Run-Masken gebaut wurden
+    uint16_t tileW;
+    uint16_t tileH;
+    uint16_t count;
+    uint32_t sourceSize;    // Größe des Quell-Sheets, 0 = ohne Quelle (direkt hochgeladenes Pack)
+};
+static_assert(sizeof(TilePackHeader) == 16, "TilePackHeader muss 16 Byte groß sein");
+
+static const uint8_t TILEPACK_VERSION = 1;
+static const size_t TILEPACK_FS_RESERVE = 64 * 1024;   // So viel Flash muss nach dem Erzeugen frei bleiben
+
+// "/dotto.png" -> "/dotto.tpk"
+static inline String tilePackPath(const String& sheetPath) {
+    int dot = sheetPath.lastIndexOf('.');
+    int slash = sheetPath.lastIndexOf('/');
+    return (dot > slash ? sheetPath.substring(0, dot) : sheetPath) + ".tpk";
+}
+
+static inline bool isTilePack(const String& path) {
+    return path.endsWith(".tpk") || path.endsWith(".TPK");
+}
+
+// --- Lesen: hält die Datei offen, damit Folgezugriffe auf dasselbe Sheet kein open kosten ---
+class TilePackReader {
+private:
+    File file;
+    String path;
+    TilePackHeader header;
+    uint32_t* offsets = nullptr;
+
+public:
+    ~TilePackReader() { close(); }
+
+    void close() {
+        if (file) file.close();
+        if (offsets) heap_caps_free(offsets);
+        offsets = nullptr;
+        path = "";
+    }
+
+    // expectedSource = Größe des Quell-Sheets (0 = nicht prüfen). False = fehlt, kaputt oder veraltet.
+    bool open(const String& packPath, uint32_t expectedSource = 0) {
+        if (offsets && path == packPath) return true;
+        close();
+        if (!LittleFS.exists(packPath)) return false;
+        file = LittleFS.open(packPath, "r");
+        if (!file) return false;
+
+        bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                  memcmp(header.magic, "MTPK", 4) == 0 && header.version == TILEPACK_VERSION &&
+                  header.count > 0 && header.tileW > 0 && header.tileW <= 255 && header.tileH > 0 &&
+                  (expectedSource == 0 || header.sourceSize == expectedSource);
+        if (ok) {
+            size_t tableSize = (header.count + 1) * sizeof(uint32_t);
+            offsets = (uint32_t*)heap_caps_malloc(tableSize, MALLOC_CAP_SPIRAM);
+            ok = offsets && file.read((uint8_t*)offsets, tableSize) == tableSize &&
+                 offsets[header.count] <= file.size();
+        }
+        if (!ok) { close(); return false; }
+        path = packPath;
+        return true;
+    }
+
+    // Liest Kachel 'index' in einen neuen PSRAM-Block: Pixel, danach Run-Maske. nullptr bei Fehler oder leerer Kachel.
+    uint8_t* readTile(uint16_t index, size_t& size) {
+        if (!offsets || index >= header.count) return nullptr;
+        uint32_t start = offsets[index], end = offsets[index + 1];
+        size_t pixelBytes = (size_t)header.tileW * header.tileH * sizeof(uint16_t);
+        if (end <= start || end - start <= pixelBytes) return nullptr;
+
+        size = end - start;
+        uint8_t* block = (uint8_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!block) return nullptr;
+        if (!file.seek(start) || file.read(block, size) != size) { heap_caps_free(block); return nullptr; }
+        return block;
+    }
+
+    bool isEmpty(uint16_t index) const { return offsets && index < header.count && offsets[index + 1] == offsets[index]; }
+    bool isOpen(const String& packPath) const { return offsets && path == packPath; }
+    const TilePackHeader& getHeader() const { return header; }
+};
+
+// --- Schreiben: Kacheln nacheinander anhängen, Offsets am Ende eintragen ---
+// Geschrieben wird in eine temporäre Datei, die erst bei finish() umbenannt wird.
+class TilePackWriter {
+private:
+    File file;
+    String path;
+    String tmpPath;
+    TilePackHeader header;
+    uint32_t* offsets = nullptr;
+    uint16_t written = 0;
+    bool failed = false;
+
+public:
+    ~TilePackWriter() { abort(); }
+
+    bool begin(const String& packPath, uint16_t tileW, uint16_t tileH, uint16_t count, uint32_t sourceSize, uint8_t threshold = 10) {
+        abort();
+        if (tileW == 0 || tileW > 255 || tileH == 0 || count == 0) return false;
+        path = packPath;
+        tmpPath = packPath + ".tmp";
+        memcpy(header.magic, "MTPK", 4);
+        header.version = TILEPACK_VERSION;
+        header.alphaThreshold = threshold;
+        header.tileW = tileW; header.tileH = tileH;
+        header.count = count;
+        header.sourceSize = sourceSize;
+
+        offsets = (uint32_t*)heap_caps_calloc(count + 1, sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+        file = LittleFS.open(tmpPath, "w");
+        if (!offsets || !file) { abort(); return false; }
+
+        // Header und leere Tabelle als Platzhalter
+        size_t tableSize = (count + 1) * sizeof(uint32_t);
+        failed = file.write((const uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+                 file.write((const uint8_t*)offsets, tableSize) != tableSize;
+        offsets[0] = sizeof(header) + tableSize;
+        written = 0;
+        return !failed;
+    }
+
+    // Hängt die nächste Kachel an (Pixel + Alpha, tileW * tileH)
+    bool addTile(const uint16_t* pixels, const uint8_t* alpha) {
+        if (!offsets || failed || written >= header.count) return false;
+        size_t runSize = 0;
+        uint8_t* runs = DisplayManager::buildRunMask(alpha, header.tileW, header.tileH, header.alphaThreshold, &runSize);
+        if (!runs) { failed = true; return false; }
+
+        // Nur Zeilen ohne Lauf: leere Kachel, nichts schreiben
+        size_t tileBytes = 0;
+        if (runSize > header.tileH) {
+            size_t pixelBytes = (size_t)header.tileW * header.tileH * sizeof(uint16_t);
+            failed = file.write((const uint8_t*)pixels, pixelBytes) != pixelBytes ||
+                     file.write(runs, runSize) != runSize;
+            tileBytes = pixelBytes + runSize;
+        }
+        heap_caps_free(runs);
+        offsets[written + 1] = offsets[written] + tileBytes;
+        written++;
+        return !failed;
+    }
+
+    // Trägt die Offsets ein und ersetzt ein vorhandenes Pack. False = unvollständig, nichts geschrieben.
+    bool finish() {
+        if (!offsets) return false;
+        bool ok = !failed && written == header.count && file.seek(sizeof(header));
+        size_t tableSize = (header.count + 1) * sizeof(uint32_t);
+        ok = ok && file.write((const uint8_t*)offsets, tableSize) == tableSize;
+        file.close();
+        heap_caps_free(offsets); offsets = nullptr;
+
+        if (ok) {
+            LittleFS.remove(path);
+            ok = LittleFS.rename(tmpPath, path);
+        }
+        if (!ok) LittleFS.remove(tmpPath);
+        return ok;
+    }
+
+    void abort() {
+        if (file) { file.close(); LittleFS.remove(tmpPath); }
+        if (offsets) heap_caps_free(offsets);
+        offsets = nullptr;
+    }
+
+    uint16_t getWritten() const { return written; }
+};
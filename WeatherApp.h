@@ -138,6 +138,12 @@ public:
         hasData = true;
     }
 
+    // Animationen laufen im 80ms Takt, Seitenwechsel liegen immer auf einem dieser Frames
+    uint32_t nextFrameDueMs(unsigned long now) override {
+        unsigned long elapsed = now - lastFrameTime;
+        return elapsed >= (unsigned long)frameDelay ? 0 : frameDelay - elapsed;
+    }
+
     bool draw(DisplayManager& display, bool force) override {
         bool needsRedraw = force;
 
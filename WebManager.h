@@ -2,10 +2,17 @@
 #include <WebServer.h>
 #include <LittleFS.h>
 #include <esp_task_wdt.h> 
+#include <lwip/sockets.h>
 #include "config.h"
+#include "PerfMonitor.h"
+#include "LiveStream.h"
+#include "TilePack.h"
+#include "AnimPack.h"
 
 extern void forceOverlay(String msg, int durationSec, String colorName);
+extern void catalogChanged();
 extern DisplayManager display; 
+extern PerfMonitor perf;
 
 // --- NEU: Empfängt den Reset-Befehl aus der HTML und reicht ihn an PongApp weiter ---
 extern bool pong_end_trigger;
@@ -153,11 +160,122 @@ class WebManager {
 private:
     WebServer server;
     File uploadFile;
+    String uploadPath;
     
     size_t uploadBytesWritten = 0;
     unsigned long lastDrawTime = 0;
     bool uploadError = false;
 
+    // --- Screenshot: Schnappschuss im PSRAM, wird über mehrere handle()-Aufrufe gestreamt ---
+    // Gesendet wird wie bei LiveStream nicht-blockierend: ein Block bleibt im Puffer, bis der Socket ihn
+    // ganz abgenommen hat, erst dann werden die nächsten Zeilen kodiert.
+    static const int SHOT_ROWS_PER_CHUNK = 4;
+    static const uint32_t SHOT_STALL_MS = 5000;   // So lange nimmt der Browser nichts ab, dann Abbruch
+    WiFiClient shotClient;
+    uint16_t* shotPixels = nullptr;
+    bool shotActive = false;
+    int16_t shotRow = -1;  // Nächste zu kodierende Zeile (BMP läuft von unten nach oben), -1 = alle kodiert
+    uint8_t shotBuf[SHOT_ROWS_PER_CHUNK * M_WIDTH * 3];
+    size_t shotLen = 0;
+    size_t shotSent = 0;
+    unsigned long shotLastProgress = 0;
+
+    LiveStream live;
+
+    // Katalog oder Icon-Sheet geändert: Tile- bzw. Animations-Pack eines ersetzten Sheets verwerfen, Index neu aufbauen
+    static void iconSourceChanged(const String& path) {
+        String lower = path;
+        lower.toLowerCase();
+        if (lower == "/catalog.json" || isTilePack(lower) || isAnimPack(lower)) { catalogChanged(); return; }
+        if (!lower.endsWith(".png") && !lower.endsWith(".bmp")) return;
+        bool changed = false;
+        for (const String& pack : { tilePackPath(path), animPackPath(path) }) {
+            if (LittleFS.exists(pack)) { LittleFS.remove(pack); changed = true; }
+        }
+        if (changed) catalogChanged();
+    }
+
+    static void putLE(uint8_t* p, uint32_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) p[i] = (v >> (8 * i)) & 0xFF;
+    }
+
+    void startScreenshot() {
+        if (shotActive) { server.send(503, "text/plain", "Screenshot läuft bereits"); return; }
+        if (!shotPixels) shotPixels = (uint16_t*)heap_caps_malloc(M_WIDTH * M_HEIGHT * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+        // Der Handler läuft im Loop zwischen zwei show()-Aufrufen, der Schnappschuss ist also konsistent
+        if (!display.captureFrame(shotPixels)) { server.send(500, "text/plain", "Kein Framebuffer"); return; }
+
+        const uint32_t rowBytes = M_WIDTH * 3;
+        const uint32_t imageBytes = rowBytes * M_HEIGHT;
+        // HTTP-Header und BMP-Header sind der erste Block
+        int n = snprintf((char*)shotBuf, sizeof(shotBuf),
+                         "HTTP/1.1 200 OK\r\nContent-Type: image/bmp\r\nCache-Control: no-store\r\nConnection: close\r\nContent-Length: %lu\r\n\r\n",
+                         (unsigned long)(54 + imageBytes));
+        uint8_t* hdr = shotBuf + n;
+        memset(hdr, 0, 54);
+        hdr[0] = 'B'; hdr[1] = 'M';
+        putLE(hdr + 2, 54 + imageBytes, 4);
+        putLE(hdr + 10, 54, 4);
+        putLE(hdr + 14, 40, 4);
+        putLE(hdr + 18, M_WIDTH, 4);
+        putLE(hdr + 22, M_HEIGHT, 4);
+        putLE(hdr + 26, 1, 2);
+        putLE(hdr + 28, 24, 2);
+        putLE(hdr + 34, imageBytes, 4);
+
+        shotClient = server.client();
+        shotLen = n + 54;
+        shotSent = 0;
+        shotRow = M_HEIGHT - 1;
+        shotActive = true;
+        shotLastProgress = millis();
+        if (!flushScreenshot()) stopScreenshot();
+    }
+
+    // Schickt so viel vom aktuellen Block, wie der Socket gerade annimmt. False = Verbindung verloren.
+    bool flushScreenshot() {
+        while (shotSent < shotLen) {
+            ssize_t r = send(shotClient.fd(), shotBuf + shotSent, shotLen - shotSent, MSG_DONTWAIT);
+            if (r > 0) { shotSent += r; shotLastProgress = millis(); continue; }
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            return false;
+        }
+        return true;
+    }
+
+    void stopScreenshot() {
+        shotClient.stop();
+        shotActive = false;
+        shotRow = -1;
+        shotLen = shotSent = 0;
+    }
+
+    // Pro Aufruf höchstens ein Block von wenigen Zeilen, blockiert nie auf den Socket
+    void pumpScreenshot() {
+        if (!shotActive) return;
+        if (!shotClient.connected() || !flushScreenshot()) { stopScreenshot(); return; }
+        if (shotSent < shotLen) {
+            if (millis() - shotLastProgress > SHOT_STALL_MS) stopScreenshot();
+            return;
+        }
+        if (shotRow < 0) { stopScreenshot(); return; }   // Letzter Block ist raus
+
+        size_t n = 0;
+        for (int i = 0; i < SHOT_ROWS_PER_CHUNK && shotRow >= 0; i++, shotRow--) {
+            const uint16_t* src = shotPixels + shotRow * M_WIDTH;
+            for (int x = 0; x < M_WIDTH; x++) {
+                uint16_t c = src[x];
+                uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+                shotBuf[n++] = (b << 3) | (b >> 2);
+                shotBuf[n++] = (g << 2) | (g >> 4);
+                shotBuf[n++] = (r << 3) | (r >> 2);
+            }
+        }
+        shotLen = n;
+        shotSent = 0;
+        if (!flushScreenshot()) stopScreenshot();
+    }
+
     String sanitizeFilename(String filename) {
         int lastSlash = filename.lastIndexOf('/');
         if (lastSlash >= 0) filename = filename.substring(lastSlash + 1);
@@ -354,6 +472,7 @@ public:
                 String fullPath = targetDir + filename;
                 uploadFile = LittleFS.open(fullPath, "w");
                 if (!uploadFile) { uploadError = true; return; }
+                uploadPath = fullPath;
                 
                 uploadBytesWritten = 0; lastDrawTime = 0; 
                 display.setBrightness(150);
@@ -381,6 +500,7 @@ public:
                 if (uploadFile) {
                     uploadFile.close();
                     if (!uploadError) drawUploadStats(upload.filename, uploadBytesWritten);
+                    if (!uploadError) iconSourceChanged(uploadPath);
                 }
             }
             else if (upload.status == UPLOAD_FILE_ABORTED) { 
@@ -402,6 +522,7 @@ public:
                 String filename = server.arg("name");
                 if(!filename.startsWith("/")) filename = "/" + filename;
                 if (LittleFS.exists(filename)) { LittleFS.remove(filename); forceOverlay("Deleted", 2, "info"); }
+                iconSourceChanged(filename);
                 int lastSlash = filename.lastIndexOf('/');
                 if (lastSlash > 0) {
                     String parent = filename.substring(0, lastSlash);
@@ -411,6 +532,21 @@ public:
             server.sendHeader("Location", redirectUrl); server.send(303);
         });
 
+        // Frame-Telemetrie des letzten abgeschlossenen Messfensters
+        server.on("/perf", HTTP_GET, [this]() {
+            server.send(200, "application/json", perf.getReport());
+        });
+
+        server.on("/screenshot.bmp", HTTP_GET, [this]() { startScreenshot(); });
+
+        // Live-Vorschau: Seite aus dem Flash, Datenstrom über /live
+        server.on("/preview", HTTP_GET, [this]() {
+            server.send_P(200, "text/html", LIVE_HTML);
+        });
+        server.on("/live", HTTP_GET, [this]() {
+            if (!live.begin(server.client())) server.send(500, "text/plain", "Kein Speicher");
+        });
+
         server.on("/pong", HTTP_GET, [this]() {
             server.send_P(200, "text/html", PONG_HTML);
         });
@@ -460,5 +596,7 @@ public:
 
     void handle() {
         server.handleClient();
+        pumpScreenshot();
+        live.pump();
     }
 };
\ No newline at end of file
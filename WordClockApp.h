@@ -2,6 +2,7 @@
 #include "App.h"
 #include "RichText.h" 
 #include <time.h>
+#include <sys/time.h>
 #include <stdio.h>
 #include "ConfigManager.h"
 
@@ -119,6 +120,26 @@ public:
         return (millis() - activeSince >= durationMs);
     }
 
+    // Im Ruhezustand ändert sich das Bild nur zur vollen Minute
+    uint32_t nextFrameDueMs(unsigned long now) override {
+        if (justActivated) return 0;
+        if (animState == MATRIX_RAIN) {
+            unsigned long elapsed = now - lastAnimFrame;
+            return elapsed > 30 ? 0 : 31 - elapsed;
+        }
+        if (animState != IDLE) return FRAME_INTERVAL_MS;
+
+        // Frühestens, wenn draw() die Uhrzeit wieder abfragt
+        unsigned long sinceCheck = now - lastTimeCheck;
+        uint32_t nextCheck = sinceCheck > TIME_CHECK_INTERVAL ? 0 : TIME_CHECK_INTERVAL + 1 - sinceCheck;
+        if (!hasValidTime) return nextCheck;
+
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        uint32_t toMinute = (59 - tv.tv_sec % 60) * 1000 + (1000 - tv.tv_usec / 1000);
+        return max(nextCheck, toMinute);
+    }
+
     bool draw(DisplayManager& display, bool force) override {
         unsigned long now = millis();
         bool needsRedraw = force;
@@ -6,6 +6,10 @@
 #define M_HEIGHT 64
 #define GAMMA_VALUE 2.2 
 
+// --- FRAME-SCHEDULER ---
+#define FRAME_INTERVAL_MS 10   // Kürzester Frame-Abstand (entspricht dem alten Polling-Takt)
+#define IDLE_FRAME_MS 1000     // Längster Schlaf ohne Deadline (statische Apps, Display aus)
+
 // Pin Definitionen (ESP32-S3 Matrix Portal)
 #define R1_PIN 42
 #define G1_PIN 41
@@ -0,0 +1,150 @@
+// --- Host-Micro-Benchmark: Auflösung von RichText-Tags (Farbe, Text-Icon, Font) ---
+// Vergleicht die frühere if-Kette auf String-Basis mit den sortierten constexpr-Tabellen
+// aus RichTextTables.h und prüft, dass beide für alle Namen dasselbe liefern.
+// Aufruf: make bench
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+#include "RichTextTables.h"
+
+// --- Alter Weg (Stand vor den Tabellen), übernommen (Farben ohne Hex-Zweig) ---
+static uint16_t legacyColor(const String& name) {
+    if (name.equalsIgnoreCase("white"))   return COL_WHITE;
+    if (name.equalsIgnoreCase("red"))     return COL_RED;
+    if (name.equalsIgnoreCase("green"))   return COL_GREEN;
+    if (name.equalsIgnoreCase("blue"))    return COL_BLUE;
+    if (name.equalsIgnoreCase("yellow"))  return COL_YELLOW;
+
+    if (name.equalsIgnoreCase("highlight")) return COL_HIGHLIGHT;
+    if (name.equalsIgnoreCase("warn"))      return COL_WARN;
+    if (name.equalsIgnoreCase("success"))   return COL_SUCCESS;
+    if (name.equalsIgnoreCase("info"))      return COL_INFO;
+    if (name.equalsIgnoreCase("muted"))     return COL_MUTED;
+    if (name.equalsIgnoreCase("warm"))      return COL_WARM;
+    if (name.equalsIgnoreCase("cold"))      return COL_COLD;
+
+    if (name.equalsIgnoreCase("gold"))      return COL_GOLD;
+    if (name.equalsIgnoreCase("silver"))    return COL_SILVER;
+
+    if (name.equalsIgnoreCase("pink"))      return COL_NEON_PINK;
+    if (name.equalsIgnoreCase("cyan"))      return COL_NEON_CYAN;
+    if (name.equalsIgnoreCase("lime"))      return COL_NEON_GREEN;
+    if (name.equalsIgnoreCase("purple"))    return COL_PURPLE;
+    if (name.equalsIgnoreCase("orange"))    return COL_ORANGE;
+    if (name.equalsIgnoreCase("magenta"))   return COL_MAGENTA;
+
+    if (name.equalsIgnoreCase("rose"))      return COL_SOFT_ROSE;
+    if (name.equalsIgnoreCase("sky"))       return COL_SOFT_SKY;
+    if (name.equalsIgnoreCase("mint"))      return COL_SOFT_MINT;
+    if (name.equalsIgnoreCase("lavender"))  return COL_SOFT_LAVENDER;
+    if (name.equalsIgnoreCase("peach"))     return COL_SOFT_PEACH;
+    if (name.equalsIgnoreCase("lemon"))     return COL_SOFT_LEMON;
+
+    return COL_WHITE;
+}
+
+static String legacyIconCode(const String& name) {
+    if (name == "sun")      return "\u2600";
+    if (name == "cloud")    return "\u2601";
+    if (name == "rain")     return "\u2602";
+    if (name == "snow")     return "\u2603";
+    if (name == "zap")      return "\u26A1";
+    if (name == "water")    return "\u2614";
+    if (name == "drop")     return "\u2614";
+    if (name == "co2")      return "\u2622";
+    if (name == "gas")      return "\u2622";
+    if (name == "bio")      return "\u2623";
+    if (name == "temp")     return "\u263C";
+    if (name == "flame")    return "\u263C";
+    if (name == "house")    return "\u2302";
+    if (name == "coffee")   return "\u2615";
+    if (name == "cup")      return "\u2615";
+    if (name == "music")    return "\u266B";
+    if (name == "heart")    return "\u2665";
+    if (name == "star")     return "\u2605";
+    if (name == "phone")      return "\u260E";
+    if (name == "smartphone") return "\u260E";
+    if (name == "print")      return "\u2709";
+    if (name == "printer")    return "\u2709";
+    if (name == "bulb")       return "\u25CF";
+    if (name == "light")      return "\u263C";
+    if (name == "wifi")       return "\u260E";
+    if (name == "power")      return "\u23E9";
+    if (name == "car")        return "\u2638";
+    if (name == "battery")    return "\u25A4";
+    if (name == "gear")       return "\u2699";
+    if (name == "switch")     return "\u2611";
+    if (name == "siren")      return "\u26A0";
+    if (name == "stopwatch")  return "\u231B";
+    if (name == "man")      return "\u2642";
+    if (name == "woman")    return "\u2640";
+    if (name == "person")   return "\u265F";
+    if (name == "smile")    return "\u263A";
+    if (name == "arrow_u")  return "\u2191"; 
+    if (name == "arrow_d")  return "\u2193"; 
+    if (name == "arrow_l")  return "\u2190"; 
+    if (name == "arrow_r")  return "\u2192"; 
+    if (name == "check")    return "\u2713"; 
+    return "?"; 
+}
+
+static FontPair legacyFont(const String& name) {
+    if (name.equalsIgnoreCase("Small")) return { u8g2_font_helvR10_tf, u8g2_font_helvB10_tf, -1, 14, 11 };
+    if (name.equalsIgnoreCase("Medium")) return { u8g2_font_helvR12_tf, u8g2_font_helvB12_tf, -2, 16, 13 };
+    if (name.equalsIgnoreCase("Large")) return { u8g2_font_helvR18_tf, u8g2_font_helvB18_tf, -4, 24, 19 };
+    return { u8g2_font_helvR12_tf, u8g2_font_helvB12_tf, -2, 16, 13 };
+}
+
+// --- Messung ---
+static volatile uint32_t sink = 0;
+
+template <typename F>
+static double nsPerCall(F&& f, int rounds) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / rounds;
+}
+
+int main() {
+    int errors = 0;
+    std::vector<const char*> colors, icons;
+    for (const RichColorEntry& e : RICH_COLORS) colors.push_back(e.name);
+    for (const RichIconEntry& e : RICH_ICONS) icons.push_back(e.name);
+    colors.push_back("Mint"); colors.push_back("unknown");
+    icons.push_back("unknown");
+    const char* fonts[] = {"Small", "Medium", "Large", "medium", "Huge"};
+
+    for (const char* c : colors) {
+        if (legacyColor(c) != richColor(c)) { printf("Farbe %s weicht ab\n", c); errors++; }
+    }
+    for (const char* i : icons) {
+        if (legacyIconCode(i) != richIconCode(i)) { printf("Icon %s weicht ab\n", i); errors++; }
+    }
+    for (const char* f : fonts) {
+        if (legacyFont(f).regular != RICH_FONTS[richFontId(f)].regular) { printf("Font %s weicht ab\n", f); errors++; }
+    }
+
+    // Typischer Tag-Mix: Name kommt als String aus dem Markup (wie tag.substring() im alten Code)
+    std::vector<String> colorTags, iconTags, fontTags;
+    for (const char* c : colors) colorTags.push_back(c);
+    for (const char* i : icons) iconTags.push_back(i);
+    for (const char* f : fonts) fontTags.push_back(f);
+    const int rounds = 20000;
+
+    double colOld = nsPerCall([&] { for (const String& s : colorTags) sink += legacyColor(s); }, rounds) / colorTags.size();
+    double colNew = nsPerCall([&] { for (const String& s : colorTags) sink += richColor(s.c_str()); }, rounds) / colorTags.size();
+    double icoOld = nsPerCall([&] { for (const String& s : iconTags) sink += legacyIconCode(s).length(); }, rounds) / iconTags.size();
+    double icoNew = nsPerCall([&] { for (const String& s : iconTags) sink += strlen(richIconCode(s.c_str())); }, rounds) / iconTags.size();
+    double fntOld = nsPerCall([&] { for (const String& s : fontTags) sink += legacyFont(s).lineHeight; }, rounds) / fontTags.size();
+    double fntNew = nsPerCall([&] { for (const String& s : fontTags) sink += RICH_FONTS[richFontId(s.c_str())].lineHeight; }, rounds) / fontTags.size();
+    // Literal als Argument: wird zur Compile-Zeit aufgelöst
+    double fntLit = nsPerCall([&] { sink += RICH_FONTS[richFontId("Medium")].lineHeight; }, rounds * 10);
+
+    printf("%-8s %10s %10s\n", "ns/tag", "if-Kette", "Tabelle");
+    printf("%-8s %10.1f %10.1f\n", "color", colOld, colNew);
+    printf("%-8s %10.1f %10.1f\n", "icon", icoOld, icoNew);
+    printf("%-8s %10.1f %10.1f  (Literal: %.1f)\n", "font", fntOld, fntNew, fntLit);
+    printf("%s\n", errors ? "FEHLER: Tabellen weichen vom alten Verhalten ab" : "Tabellen identisch zum alten Verhalten");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,663 @@
+// --- Matrix OS Host-Build: Apps headless rendern, Frames vergleichen, CPU-Zeit messen ---
+// Aufruf: matrix_host [--data DIR] [--out DIR] [--golden DIR] [--update-golden] [--app NAME] [--quiet]
+//         matrix_host --fetch URL [--fetch-icons ln:2356,la:4907]   Icon-Download gegen einen lokalen HTTP-Server
+//         matrix_host --data fixtures --gif-bench                  GIF-Umwandlung für alle DATA/bench/*.gif messen
+//         matrix_host --richtext-bench                             RichText: Markup pro Frame parsen gegen Display-Liste abspielen
+//         matrix_host --soak [N]                                   N Katalog-Icons laden/verdrängen, PSRAM-Fragmentierung messen
+//         matrix_host --app roundtrip                              nur Round-Trips (Tile-Pack, Animations-Pack, Cache-Budget)
+// Rückgabe: 0 = keine abweichenden Frames (fehlende Golden-Bilder werden übersprungen) und alle Round-Trips bestanden
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "config.h"
+#include "DisplayManager.h"
+#include "ConfigManager.h"
+#include "IconManager.h"
+#include "RichText.h"
+#include "WordClockApp.h"
+#include "SensorApp.h"
+#include "WeatherApp.h"
+#include "TickerApp.h"
+#include "PlasmaApp.h"
+
+// --- Globale Objekte, die im Sketch in Matrix_OS.ino liegen ---
+AppMode currentApp = WORDCLOCK;
+int brightness = 150;
+int pong_p1_dir = 0;
+int pong_p2_dir = 0;
+bool pong_p1_ready = false;
+bool pong_p2_ready = false;
+bool pong_start_trigger = false;
+
+ConfigManager configManager;
+DisplayManager display;
+IconManager iconManager;
+
+WordClockApp appWordClock;
+SensorApp appSensors;
+WeatherApp weatherApp;
+TickerApp appTicker;
+PlasmaApp appPlasma;
+
+// --- Wanduhr: folgt der Skript-Zeit (ersetzt time() und gettimeofday() der libc) ---
+static time_t epochBase = 0;
+
+extern "C" time_t time(time_t* t) noexcept {
+    time_t now = epochBase + (time_t)(host::nowMicros / 1000000);
+    if (t) *t = now;
+    return now;
+}
+
+extern "C" int gettimeofday(struct timeval* __restrict tv, void* __restrict tz) noexcept {
+    if (tv) {
+        tv->tv_sec = epochBase + (time_t)(host::nowMicros / 1000000);
+        tv->tv_usec = (suseconds_t)(host::nowMicros % 1000000);
+    }
+    return 0;
+}
+
+static uint64_t cpuMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// --- Szenarien: App, Startzeit, Dauer und Zeitpunkte (ms) für Frame-Dumps ---
+struct Scenario {
+    const char* name;
+    AppMode mode;
+    App* app;
+    time_t startEpoch;
+    uint32_t durationMs;
+    std::vector<uint32_t> dumpAt;
+    std::function<void()> setup;
+};
+
+// 2024-06-01 12:34:58 UTC: zwei Sekunden vor einem Fünf-Minuten-Wechsel der Wortuhr
+static const time_t DEFAULT_EPOCH = 1717245298;
+
+static void setupSensors() {
+    std::vector<SensorItem> room = {
+        {"ti:sun", "22.5°C", "white"},
+        {"", "45%", "blue"},
+        {"", "812 ppm", "mint"},
+    };
+    appSensors.updatePage("wohnzimmer", "Wohnzimmer", 600, 3, room);
+    std::vector<SensorItem> door = { {"", "Tür offen", "red"} };
+    appSensors.updatePage("haustuer", "Haustür", 600, 2, door);
+}
+
+static void setupWeather() {
+    static const char* json = R"({
+        "validity": 3600,
+        "current": {"cond": "partlycloudy", "temp": 18.4, "precip": 0.2, "wind": 12.0, "wind_dir": 240, "wind_gust": 25.0},
+        "forecasts": [
+            {"day": "Sa", "cond": "sunny", "tmin": 11.0, "tmax": 24.0, "precip": 0.0, "wind": 8.0, "wind_dir": 90, "wind_gust": 15.0, "precip_prob": 5},
+            {"day": "So", "cond": "rainy", "tmin": 12.0, "tmax": 17.0, "precip": 6.5, "wind": 20.0, "wind_dir": 270, "wind_gust": 45.0, "precip_prob": 80},
+            {"day": "Mo", "cond": "cloudy", "tmin": 9.0, "tmax": 15.0, "precip": 1.0, "wind": 14.0, "wind_dir": 300, "wind_gust": 30.0, "precip_prob": 40}
+        ],
+        "hourly": [
+            {"time_str": "13:00", "cond": "sunny", "temp": 19.0, "precip_prob": 0, "precip": 0.0},
+            {"time_str": "14:00", "cond": "partlycloudy", "temp": 20.0, "precip_prob": 10, "precip": 0.0},
+            {"time_str": "15:00", "cond": "cloudy", "temp": 19.5, "precip_prob": 30, "precip": 0.4},
+            {"time_str": "16:00", "cond": "rainy", "temp": 17.0, "precip_prob": 70, "precip": 2.1}
+        ],
+        "local": {"ltemp": 22.5, "humidity": 45.0, "pm25": 7.0, "voc": 110}
+    })";
+    SpiRamJsonDocument doc(8192);
+    deserializeJson(doc, json);
+    weatherApp.setup();
+    weatherApp.updateData(&doc);
+}
+
+static void setupTicker() {
+    appTicker.setMessage("{c:mint}Matrix OS Host:{c:white}  Font Icons: {sun}{star}{arrow_u}  {c:gold}22.5°C {c:cyan}45%");
+}
+
+// --- Bild-Ausgabe ---
+static std::vector<uint8_t> toRGB(const uint16_t* px) {
+    std::vector<uint8_t> rgb(M_WIDTH * M_HEIGHT * 3);
+    for (int i = 0; i < M_WIDTH * M_HEIGHT; i++) {
+        uint16_t c = px[i];
+        uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        rgb[i * 3] = (r << 3) | (r >> 2);
+        rgb[i * 3 + 1] = (g << 2) | (g >> 4);
+        rgb[i * 3 + 2] = (b << 3) | (b >> 2);
+    }
+    return rgb;
+}
+
+static bool writePPM(const std::string& path, const std::vector<uint8_t>& rgb) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", M_WIDTH, M_HEIGHT);
+    fwrite(rgb.data(), 1, rgb.size(), f);
+    fclose(f);
+    return true;
+}
+
+static bool readPPM(const std::string& path, std::vector<uint8_t>& rgb) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    int w = 0, h = 0, maxv = 0;
+    bool ok = fscanf(f, "P6 %d %d %d", &w, &h, &maxv) == 3 && w == M_WIDTH && h == M_HEIGHT && maxv == 255 && fgetc(f) != EOF;
+    rgb.assign(M_WIDTH * M_HEIGHT * 3, 0);
+    ok = ok && fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    fclose(f);
+    return ok;
+}
+
+struct Options {
+    std::string data = "../data";
+    std::string out = "out";
+    std::string golden = "golden";
+    std::string only;
+    bool updateGolden = false;
+    std::string fetchUrl;
+    std::string fetchIcons = "ln:2356,la:4907";
+    bool gifBench = false;
+    bool animBench = false;
+    bool richTextBench = false;
+    uint32_t soakLoads = 0;
+};
+
+static uint64_t wallMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// --- Icon-Download im Hintergrund: Ticker mit LaMetric-IDs, die lokal fehlen ---
+// Die Icons kommen von einem lokalen Server (z.B. "python3 -m http.server 8000" in einem Ordner mit
+// 2356.png und 4907.gif). Gemessen wird die Wanduhr-Zeit jedes processFetches()-Aufrufs; der Loop
+// darf dabei nie länger als eine Zeitscheibe stehen. Frames: vorher (Platzhalter) und nachher.
+static int runFetch(const Options& opt) {
+    host::nowMicros = 0;
+    epochBase = DEFAULT_EPOCH;
+    WiFi.setConnected(true);
+    iconManager.setIconBaseUrl(opt.fetchUrl.c_str());
+
+    String msg = "{c:white}Icons:";
+    String list = opt.fetchIcons.c_str();
+    while (list.length()) {
+        int comma = list.indexOf(',');
+        String tag = comma < 0 ? list : list.substring(0, comma);
+        list = comma < 0 ? String() : list.substring(comma + 1);
+        if (tag.length() < 4) continue;
+        // Lokale Kopie entfernen, damit wirklich geladen wird
+        String id = tag.substring(3);
+        if (tag.startsWith("la:")) LittleFS.remove("/iconsan/" + id + ".ani");
+        else LittleFS.remove("/icons/" + id + ".bmp");
+        msg += " {" + tag + "}";
+    }
+
+    currentApp = TICKER;
+    display.setLayer(LAYER_APP);
+    display.setAppFade(1.0);
+    appTicker.setMessage(msg);
+    appTicker.onActive();
+
+    std::vector<uint16_t> frame(M_WIDTH * M_HEIGHT);
+    uint64_t maxSlice = 0, total = 0;
+    uint32_t calls = 0, frames = 0, arrived = 0;
+    bool first = true;
+    while (millis() < 20000) {
+        uint64_t t0 = wallMicros();
+        bool done = iconManager.processFetches(8);
+        uint64_t dt = wallMicros() - t0;
+        if (iconManager.isFetching() || done) { calls++; total += dt; if (dt > maxSlice) maxSlice = dt; }
+        if (done) arrived++;
+
+        if (appTicker.draw(display, first || done)) display.show();
+        if (first) {
+            display.captureFrame(frame.data());
+            writePPM(opt.out + "/fetch_pending.ppm", toRGB(frame.data()));
+        }
+        first = false;
+        frames++;
+        if (!iconManager.isFetching() && !done) break;
+        host::advance(FRAME_INTERVAL_MS);
+        usleep(1000);   // Dem Server Zeit geben, die Skript-Zeit läuft sonst davon
+    }
+    display.captureFrame(frame.data());
+    writePPM(opt.out + "/fetch_done.ppm", toRGB(frame.data()));
+
+    printf("fetch      icons=%u frames=%u slices=%u slice_us avg=%llu max=%llu cache=%u sperren=%u\n",
+           (unsigned)arrived, (unsigned)frames, (unsigned)calls, (unsigned long long)(calls ? total / calls : 0),
+           (unsigned long long)maxSlice, (unsigned)iconManager.getCacheCount(), (unsigned)iconManager.getMissCount());
+    return iconManager.getMissCount() ? 1 : 0;
+}
+
+// Führt ein Szenario aus. Rückgabe: Anzahl abweichender Frames.
+static int runScenario(const Scenario& sc, const Options& opt, int& skipped) {
+    host::nowMicros = 0;
+    epochBase = sc.startEpoch;
+    randomSeed(1);
+    currentApp = sc.mode;
+    display.setLayer(LAYER_APP);
+    display.setAppFade(1.0);
+    display.endIndexed();
+    if (sc.setup) sc.setup();
+    sc.app->onActive();
+
+    std::vector<uint32_t> cpu;
+    uint64_t pushed = 0;
+    size_t nextDump = 0;
+    int failures = 0;
+    std::vector<uint16_t> frame(M_WIDTH * M_HEIGHT);
+
+    for (bool first = true; millis() <= sc.durationMs; first = false) {
+        uint64_t t0 = cpuMicros();
+        bool changed = sc.app->draw(display, first);
+        if (changed) display.show();
+        cpu.push_back((uint32_t)(cpuMicros() - t0));
+        if (changed) pushed += display.getLastPushedPixels();
+
+        while (nextDump < sc.dumpAt.size() && millis() >= sc.dumpAt[nextDump]) {
+            char file[96];
+            snprintf(file, sizeof(file), "%s_%05u.ppm", sc.name, (unsigned)sc.dumpAt[nextDump]);
+            display.captureFrame(frame.data());
+            std::vector<uint8_t> rgb = toRGB(frame.data());
+            writePPM(opt.out + "/" + file, rgb);
+
+            std::string goldenPath = opt.golden + "/" + file;
+            std::vector<uint8_t> expected;
+            if (opt.updateGolden) {
+                writePPM(goldenPath, rgb);
+            } else if (!readPPM(goldenPath, expected)) {
+                // Ohne Vergleichsbild ist nichts geprüft: nicht als bestanden zählen, aber auch nicht als Fehler
+                skipped++;
+            } else {
+                int diff = 0;
+                for (size_t i = 0; i < rgb.size(); i += 3) {
+                    if (memcmp(&rgb[i], &expected[i], 3)) diff++;
+                }
+                if (diff) { printf("  %-24s FEHLER: %d Pixel abweichend\n", file, diff); failures++; }
+            }
+            nextDump++;
+        }
+
+        // Wie der Frame-Scheduler im Sketch: bis zur nächsten Deadline der App vorspulen
+        uint32_t due = sc.app->nextFrameDueMs(millis());
+        host::advance(constrain(due, (uint32_t)1, (uint32_t)IDLE_FRAME_MS));
+    }
+
+    std::vector<uint32_t> sorted = cpu;
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t sum = 0;
+    for (uint32_t v : cpu) sum += v;
+    size_t n = cpu.size();
+    printf("%-10s frames=%-5zu cpu_us avg=%-6llu p95=%-6u max=%-6u px/frame=%llu\n",
+           sc.name, n, (unsigned long long)(n ? sum / n : 0),
+           n ? sorted[(n * 95) / 100 < n ? (n * 95) / 100 : n - 1] : 0, n ? sorted.back() : 0,
+           (unsigned long long)(n ? pushed / n : 0));
+    return failures;
+}
+
+// --- GIF-Umwandlung: alle DATA/bench/*.gif, Wanduhr-Zeit (die Skript-Uhr steht während der Umwandlung) ---
+static int runGifBench() {
+    File root = LittleFS.open("/bench");
+    if (!root || !root.isDirectory()) { fprintf(stderr, "Kein Ordner bench/ im Datenverzeichnis\n"); return 2; }
+    for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+        String name = f.name();
+        f.close();
+        if (!name.endsWith(".gif")) continue;
+        int slash = name.lastIndexOf('/');
+        String path = "/bench/" + (slash >= 0 ? name.substring(slash + 1) : name);
+        uint64_t t0 = wallMicros();
+        String json = iconManager.benchGif(path);
+        printf("gif        %-24s wall_us=%-8llu %s\n", path.c_str(), (unsigned long long)(wallMicros() - t0), json.c_str());
+    }
+    return 0;
+}
+
+// --- Katalog-Animationen: Sheet (alter Ladeweg) gegen Animations-Pack ---
+// Die Zeiten im JSON laufen über die Skript-Uhr und bleiben hier 0; aussagekräftig sind Speicher und
+// Flash, dazu die Wanduhr-Zeit des ganzen Durchlaufs (legt ein fehlendes Pack an).
+static int runAnimBench() {
+    iconManager.ensureCatalog();
+    IconCatalog& catalog = iconManager.getCatalog();
+    for (uint16_t i = 0; i < catalog.getAnimCount(); i++) {
+        uint64_t t0 = wallMicros();
+        String json = iconManager.benchAnim(catalog.getAnim(i));
+        printf("anim       wall_us=%-8llu %s\n", (unsigned long long)(wallMicros() - t0), json.c_str());
+    }
+    return 0;
+}
+
+// --- RichText: Markup jeden Frame parsen (drawString) gegen einmal kompilierte Display-Liste (draw) ---
+// Wie benchRichText im Sketch, aber mit CPU-Zeit und mehr Frames. Prüft außerdem, dass beide Wege
+// dasselbe Bild ergeben. Rückgabe 1 = Bilder weichen ab.
+static int runRichTextBench() {
+    const int FRAMES = 2000;
+    const String msg = "{c:mint}Matrix OS:{c:white}  Font Icons: {sun}{star}{arrow_u}  {b}Fett{b} {u}unterstrichen{u}  {c:gold}22.5°C {c:cyan}45%";
+    String longMsg;
+    for (int i = 0; i < 8; i++) longMsg += msg + "  ";
+
+    currentApp = TICKER;
+    display.setLayer(LAYER_APP);
+    display.setAppFade(1.0);
+    RichText rt;
+    RichTextList list, longList;
+
+    uint64_t t0 = cpuMicros();
+    for (int i = 0; i < FRAMES; i++) rt.compileInto(display, msg, "Medium", list);
+    double compileUs = (double)(cpuMicros() - t0) / FRAMES;
+    rt.compileInto(display, longMsg, "Medium", longList);
+
+    // Gleiches Bild über beide Wege, an einigen Scroll-Positionen
+    std::vector<uint16_t> a(M_WIDTH * M_HEIGHT), b(M_WIDTH * M_HEIGHT);
+    int diff = 0;
+    for (int x : {M_WIDTH, 40, 0, -50, -list.width / 2}) {
+        display.clear();
+        rt.drawString(display, x, 38, msg, "Medium");
+        display.show();
+        display.captureFrame(a.data());
+        display.clear();
+        rt.draw(display, x, 38, list);
+        display.show();
+        display.captureFrame(b.data());
+        for (int i = 0; i < M_WIDTH * M_HEIGHT; i++) diff += a[i] != b[i];
+    }
+
+    double us[3];
+    for (int pass = 0; pass < 3; pass++) {
+        t0 = cpuMicros();
+        for (int i = 0; i < FRAMES; i++) {
+            int x = M_WIDTH - (i * 4) % (list.width + M_WIDTH);
+            if (pass == 0) rt.drawString(display, x, 38, msg, "Medium");
+            else if (pass == 1) rt.draw(display, x, 38, list);
+            else rt.draw(display, x - longList.width / 2, 38, longList);
+        }
+        us[pass] = (double)(cpuMicros() - t0) / FRAMES;
+    }
+
+    printf("richtext   frames=%d parse_us=%.2f replay_us=%.2f replay_8x_us=%.2f compile_us=%.2f spans=%u speedup=%.1fx pixel_diff=%d\n",
+           FRAMES, us[0], us[1], us[2], compileUs, (unsigned)list.spans.size(), us[1] > 0 ? us[0] / us[1] : 0.0, diff);
+    return diff ? 1 : 0;
+}
+
+// --- Round-Trips: Packs schreiben und wieder lesen, Cache-Budget ---
+// Läuft mit synthetischen Bildern ohne Bibliotheken (kein PNG/GIF), die Dateien werden danach gelöscht.
+// Jede Prüfung ist bit-genau; Rückgabe = Anzahl Fehler.
+static int rtFail(const char* check, const char* what) {
+    printf("  %-24s FEHLER: %s\n", check, what);
+    return 1;
+}
+
+// Testbild 'f': Farbverlauf mit wanderndem 3x3-Block, Spalte 0 und ein Streumuster transparent.
+// Die Farben sind in RGB565 exakt darstellbar (BMP-Umweg verliert nichts).
+static void makeTestImage(uint16_t* px, uint8_t* alpha, int w, int h, int f) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int i = y * w + x;
+            px[i] = (uint16_t)(((x * 3) & 0x1F) << 11 | ((y * 5 + f) & 0x3F) << 5 | ((x + y) & 0x1F));
+            if (x >= f * 2 && x < f * 2 + 3 && y >= 2 && y < 5) px[i] = (uint16_t)(0xFFFF - f);
+            alpha[i] = (x == 0 || (x + y + f) % 7 == 0) ? 0 : 255;
+        }
+    }
+}
+
+// Vergleicht eine Run-Maske mit der, die DisplayManager::buildRunMask aus 'alpha' baut (size 0 = Länge unbekannt)
+static bool sameRuns(const uint8_t* runs, size_t size, const uint8_t* alpha, int w, int h, uint8_t threshold) {
+    size_t expectedSize = 0;
+    uint8_t* expected = DisplayManager::buildRunMask(alpha, w, h, threshold, &expectedSize);
+    bool same = expected && (size == 0 || size == expectedSize) && memcmp(runs, expected, expectedSize) == 0;
+    if (expected) heap_caps_free(expected);
+    return same;
+}
+
+// Tile-Pack: Kacheln schreiben, Header, leere Kachel, Pixel und Masken zurücklesen
+static int checkTilePack() {
+    const int W = 12, H = 10, COUNT = 4, EMPTY = 2;
+    const uint32_t SOURCE = 4711;
+    const String path = "/roundtrip.tpk";
+    std::vector<uint16_t> px(W * H * COUNT);
+    std::vector<uint8_t> alpha(W * H * COUNT);
+    for (int t = 0; t < COUNT; t++) makeTestImage(&px[t * W * H], &alpha[t * W * H], W, H, t);
+    memset(&alpha[EMPTY * W * H], 0, W * H);
+
+    int fails = 0;
+    TilePackWriter writer;
+    bool written = writer.begin(path, W, H, COUNT, SOURCE);
+    for (int t = 0; written && t < COUNT; t++) written = writer.addTile(&px[t * W * H], &alpha[t * W * H]);
+    if (!written || !writer.finish()) return rtFail("tilepack", "Schreiben fehlgeschlagen");
+
+    TilePackReader reader;
+    if (reader.open(path, SOURCE + 1)) fails += rtFail("tilepack", "veraltete Quelle nicht erkannt");
+    if (!reader.open(path, SOURCE)) {
+        LittleFS.remove(path);
+        return fails + rtFail("tilepack", "Öffnen fehlgeschlagen");
+    }
+    const TilePackHeader& h = reader.getHeader();
+    if (h.tileW != W || h.tileH != H || h.count != COUNT) fails += rtFail("tilepack", "Header weicht ab");
+
+    for (int t = 0; t < COUNT; t++) {
+        size_t size = 0;
+        uint8_t* block = reader.readTile(t, size);
+        if (t == EMPTY) {
+            if (!reader.isEmpty(t) || block) fails += rtFail("tilepack", "leere Kachel belegt Platz");
+        } else if (!block || reader.isEmpty(t)) {
+            fails += rtFail("tilepack", "Kachel fehlt");
+        } else {
+            size_t pixelBytes = W * H * sizeof(uint16_t);
+            if (memcmp(block, &px[t * W * H], pixelBytes)) fails += rtFail("tilepack", "Pixel weichen ab");
+            if (!sameRuns(block + pixelBytes, size - pixelBytes, &alpha[t * W * H], W, H, h.alphaThreshold))
+                fails += rtFail("tilepack", "Run-Maske weicht ab");
+        }
+        if (block) heap_caps_free(block);
+    }
+    reader.close();
+    LittleFS.remove(path);
+    printf("%-10s tiles=%d empty=1 %s\n", "tilepack", COUNT, fails ? "FEHLER" : "ok");
+    return fails;
+}
+
+// Animations-Pack: Deltas schreiben, über den IconManager laden und in wechselnder Reihenfolge
+// abspielen. Rückwärtssprünge (Schleifenende) müssen ab einem schwarzen Frame neu aufbauen, sonst
+// bleiben Pixel späterer Frames stehen.
+static int checkAnimPack() {
+    const int W = 12, H = 10, FRAMES = 5;
+    const String id = "roundtrip";
+    const String path = "/iconsan/" + id + ".ani";
+    std::vector<uint16_t> px(W * H * FRAMES);
+    std::vector<uint8_t> alpha(W * H * FRAMES);
+    for (int f = 0; f < FRAMES; f++) makeTestImage(&px[f * W * H], &alpha[f * W * H], W, H, f);
+
+    LittleFS.mkdir("/iconsan");
+    AnimPackWriter writer;
+    bool written = writer.begin(path, W, H, FRAMES);
+    for (int f = 0; written && f < FRAMES; f++) written = writer.addFrame(&px[f * W * H], &alpha[f * W * H], 100 + f * 10);
+    if (!written || !writer.finish()) return rtFail("animpack", "Schreiben fehlgeschlagen");
+    uint8_t threshold = writer.getHeader().alphaThreshold;
+
+    int fails = 0;
+    AnimatedIcon* anim = iconManager.getAnimatedIcon(id);
+    if (!anim || !anim->data || anim->frameCount != FRAMES || anim->width != W || anim->height != H) {
+        LittleFS.remove(path);
+        return rtFail("animpack", "Laden fehlgeschlagen");
+    }
+    if (anim->totalTime != FRAMES * 100 + 10 * (FRAMES * (FRAMES - 1) / 2)) fails += rtFail("animpack", "Delays weichen ab");
+
+    // Vorwärts, Sprung zurück auf 0 (Schleife), mitten hinein und wieder zurück
+    const int order[] = {0, 1, 2, 3, 4, 0, 3, 1, 1, 4, 2};
+    for (int f : order) {
+        const uint16_t* frame = iconManager.getAnimFrame(anim, f);
+        const uint16_t* src = &px[f * W * H];
+        const uint8_t* a = &alpha[f * W * H];
+        int diff = 0;
+        for (int i = 0; i < W * H; i++) diff += a[i] > threshold && frame[i] != src[i];
+        if (diff) { fails += rtFail("animpack", ("Frame " + std::to_string(f) + ": " + std::to_string(diff) + " Pixel abweichend").c_str()); }
+        if (!sameRuns(anim->runs + anim->frames[f].runs, 0, a, W, H, threshold)) fails += rtFail("animpack", "Run-Maske weicht ab");
+    }
+    iconManager.clearCaches();
+    LittleFS.remove(path);
+    printf("%-10s frames=%d steps=%zu pack_bytes=%u %s\n", "animpack", FRAMES, sizeof(order) / sizeof(order[0]),
+           (unsigned)writer.getBytes(), fails ? "FEHLER" : "ok");
+    return fails;
+}
+
+// 32-Bit-BMP (von oben nach unten) wie es der IconManager aus /icons/ liest
+static bool writeBmp(const String& path, const uint16_t* px, const uint8_t* alpha, int w, int h) {
+    uint8_t header[54] = {'B', 'M'};
+    uint32_t dataBytes = w * h * 4;
+    auto put32 = [&](int off, uint32_t v) { memcpy(header + off, &v, 4); };
+    put32(2, sizeof(header) + dataBytes);
+    put32(10, sizeof(header));
+    put32(14, 40);
+    put32(18, w);
+    put32(22, (uint32_t)-h);
+    header[26] = 1; header[28] = 32;
+    put32(34, dataBytes);
+    std::vector<uint8_t> data(dataBytes);
+    for (int i = 0; i < w * h; i++) {
+        data[i * 4 + 0] = (px[i] & 0x1F) << 3;
+        data[i * 4 + 1] = ((px[i] >> 5) & 0x3F) << 2;
+        data[i * 4 + 2] = (px[i] >> 11) << 3;
+        data[i * 4 + 3] = alpha[i];
+    }
+    File f = LittleFS.open(path, "w");
+    if (!f) return false;
+    bool ok = f.write(header, sizeof(header)) == sizeof(header) && f.write(data.data(), dataBytes) == dataBytes;
+    f.close();
+    return ok;
+}
+
+// Icon-Cache: mehr Icons laden, als ins Byte-Budget passen. Das Budget darf nie überschritten
+// werden, verdrängt wird der am längsten unbenutzte Eintrag, alte Handles laufen ins Leere.
+static int checkIconCache() {
+    const int W = 12, H = 10, COUNT = 8, FIT = 3;
+    std::vector<uint16_t> px(W * H);
+    std::vector<uint8_t> alpha(W * H);
+    std::vector<String> names;
+    LittleFS.mkdir("/icons");
+    bool written = true;
+    for (int i = 0; i < COUNT && written; i++) {
+        names.push_back("roundtrip" + String(i));
+        makeTestImage(px.data(), alpha.data(), W, H, i);
+        written = writeBmp("/icons/" + names[i] + ".bmp", px.data(), alpha.data(), W, H);
+    }
+
+    int fails = 0;
+    size_t savedBudget = iconManager.getCacheBudget();
+    iconManager.clearCaches();
+    IconHandle first = written ? iconManager.getIconHandle(names[0]) : 0;
+    CachedIcon* icon = iconManager.getIcon(first);
+    if (!icon) fails += rtFail("iconcache", "Laden fehlgeschlagen");
+    else {
+        makeTestImage(px.data(), alpha.data(), W, H, 0);
+        if (icon->width != W || icon->height != H || memcmp(icon->pixels, px.data(), W * H * sizeof(uint16_t)))
+            fails += rtFail("iconcache", "Pixel weichen ab");
+        if (!sameRuns(icon->runs, 0, alpha.data(), W, H, 10)) fails += rtFail("iconcache", "Run-Maske weicht ab");
+    }
+
+    // Platz für FIT Icons; Icon 0 wird ab dem zweiten immer wieder benutzt und muss bleiben
+    size_t iconBytes = iconManager.getCacheBytes();
+    iconManager.setCacheBudget(iconBytes * FIT + iconBytes / 2);
+    uint32_t evictions = iconManager.getCacheEvictions();
+    std::vector<IconHandle> handles = {first};
+    for (int i = 1; i < COUNT && !fails; i++) {
+        handles.push_back(iconManager.getIconHandle(names[i]));
+        iconManager.getIcon(first);
+        if (iconManager.getCacheBytes() > iconManager.getCacheBudget()) fails += rtFail("iconcache", "Budget überschritten");
+    }
+    evictions = iconManager.getCacheEvictions() - evictions;
+    if (!fails) {
+        if (evictions != COUNT - FIT) fails += rtFail("iconcache", "falsche Zahl an Verdrängungen");
+        if (!iconManager.getIcon(first)) fails += rtFail("iconcache", "zuletzt benutztes Icon verdrängt");
+        if (!iconManager.getIcon(handles[COUNT - 1])) fails += rtFail("iconcache", "neuestes Icon verdrängt");
+        for (int i = 1; i < COUNT - FIT + 1; i++) {
+            if (iconManager.getIcon(handles[i])) fails += rtFail("iconcache", "Handle eines verdrängten Icons gültig");
+        }
+    }
+
+    iconManager.clearCaches();
+    iconManager.setCacheBudget(savedBudget);
+    for (const String& name : names) LittleFS.remove("/icons/" + name + ".bmp");
+    printf("%-10s loads=%d budget=%d icons evictions=%u %s\n", "iconcache", COUNT, FIT, (unsigned)evictions, fails ? "FEHLER" : "ok");
+    return fails;
+}
+
+static int runRoundTrips() {
+    return checkTilePack() + checkAnimPack() + checkIconCache();
+}
+
+// --- Fragmentierungs-Dauertest gegen das PSRAM-Modell des Shims ---
+// Misst nur Speicher; die Zeiten laufen über die Skript-Uhr.
+static int runSoak(uint32_t loads) {
+    uint64_t t0 = wallMicros();
+    String json = iconManager.soakIcons(loads);
+    printf("soak       wall_us=%-8llu %s\n", (unsigned long long)(wallMicros() - t0), json.c_str());
+    return json == "{}" ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--data" && i + 1 < argc) opt.data = argv[++i];
+        else if (a == "--out" && i + 1 < argc) opt.out = argv[++i];
+        else if (a == "--golden" && i + 1 < argc) opt.golden = argv[++i];
+        else if (a == "--app" && i + 1 < argc) opt.only = argv[++i];
+        else if (a == "--update-golden") opt.updateGolden = true;
+        else if (a == "--quiet") Serial.quiet = true;
+        else if (a == "--fetch" && i + 1 < argc) opt.fetchUrl = argv[++i];
+        else if (a == "--fetch-icons" && i + 1 < argc) opt.fetchIcons = argv[++i];
+        else if (a == "--gif-bench") opt.gifBench = true;
+        else if (a == "--anim-bench") opt.animBench = true;
+        else if (a == "--richtext-bench") opt.richTextBench = true;
+        else if (a == "--soak") {
+            opt.soakLoads = 5000;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) opt.soakLoads = atoi(argv[++i]);
+        }
+        else { fprintf(stderr, "Unbekannte Option: %s\n", argv[i]); return 2; }
+    }
+
+    // Vor der ersten PSRAM-Anforderung: sonst liegt ein Teil im normalen Heap und zählt nicht mit
+    if (opt.soakLoads) host::psramModel = true;
+
+    setenv("TZ", "UTC", 1);
+    tzset();
+    mkdir(opt.out.c_str(), 0755);
+    if (opt.updateGolden) mkdir(opt.golden.c_str(), 0755);
+
+    LittleFS.setRoot(opt.data);
+    LittleFS.begin();
+    configManager.begin();
+    if (!display.begin()) { fprintf(stderr, "display.begin() fehlgeschlagen\n"); return 2; }
+    display.setBrightness(brightness);
+    iconManager.begin();
+    if (!opt.fetchUrl.empty()) return runFetch(opt);
+    if (opt.gifBench) return runGifBench();
+    if (opt.animBench) return runAnimBench();
+    if (opt.richTextBench) return runRichTextBench();
+    if (opt.soakLoads) return runSoak(opt.soakLoads);
+
+    std::vector<Scenario> scenarios = {
+        {"wordclock", WORDCLOCK, &appWordClock, DEFAULT_EPOCH, 8000, {0, 1500, 3000, 7900}, nullptr},
+        {"sensors",   SENSORS,   &appSensors,   DEFAULT_EPOCH, 20000, {0, 10000}, setupSensors},
+        {"weather",   WEATHER,   &weatherApp,   DEFAULT_EPOCH, 15000, {0, 5000, 13000}, setupWeather},
+        {"ticker",    TICKER,    &appTicker,    DEFAULT_EPOCH, 6000, {0, 2000, 4000}, setupTicker},
+        {"plasma",    PLASMA,    &appPlasma,    DEFAULT_EPOCH, 2000, {0, 1000}, nullptr},
+    };
+
+    int failures = 0, skipped = 0;
+    for (const Scenario& sc : scenarios) {
+        if (!opt.only.empty() && opt.only != sc.name) continue;
+        failures += runScenario(sc, opt, skipped);
+    }
+    int roundTripFailures = opt.only.empty() || opt.only == "roundtrip" ? runRoundTrips() : 0;
+
+    if (opt.only != "roundtrip") {
+        if (opt.updateGolden) printf("Golden-Bilder aktualisiert: %s\n", opt.golden.c_str());
+        else if (failures) printf("%d Frame(s) weichen ab (neu schreiben: make golden)\n", failures);
+        else if (skipped) printf("Vergleich übersprungen: %d Frame(s) ohne Golden-Bild in %s (anlegen: make golden)\n", skipped, opt.golden.c_str());
+        else printf("Alle Frames identisch\n");
+    }
+    if (roundTripFailures) printf("%d Round-Trip-Prüfung(en) fehlgeschlagen\n", roundTripFailures);
+    return failures || roundTripFailures ? 1 : 0;
+}
@@ -0,0 +1,2 @@
+#pragma once
+// Host-Shim: Adafruit_GFX bindet BusIO ein, der Host-Build braucht davon nichts.
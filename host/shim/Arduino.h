@@ -0,0 +1,105 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include "WString.h"
+#include "Print.h"
+#include "esp_heap_caps.h"
+
+// --- Host-Shim: Arduino-Kern für den Linux-Build (siehe host/Makefile) ---
+// Zeit ist skriptgesteuert: millis()/micros() laufen nur, wenn der Treiber host::advance() aufruft.
+
+using std::min;
+using std::max;
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define PROGMEM
+#define IRAM_ATTR
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_float(addr) (*(const float*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+namespace host {
+    extern uint64_t nowMicros;
+    inline void advance(uint32_t ms) { nowMicros += (uint64_t)ms * 1000; }
+}
+
+inline unsigned long millis() { return (unsigned long)(host::nowMicros / 1000); }
+inline unsigned long micros() { return (unsigned long)host::nowMicros; }
+inline void delay(unsigned long ms) { host::advance(ms); }
+inline void delayMicroseconds(unsigned int us) { host::nowMicros += us; }
+inline void yield() {}
+
+// FreeRTOS-Tasks als Threads, nur was der Sketch benutzt. Eine Task endet mit vTaskDelete(nullptr) als letzter Anweisung.
+typedef void (*TaskFunction_t)(void*);
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+#define pdPASS 1
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes, void* arg,
+                                   unsigned priority, TaskHandle_t* handle, int core);
+inline void vTaskDelete(TaskHandle_t) {}
+
+// Deterministischer Zufall, damit Golden-Bilder reproduzierbar sind
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) return outMin;
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+inline bool isDigit(int c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(int c) { return isalpha(c); }
+inline bool isAlphaNumeric(int c) { return isalnum(c); }
+inline bool isSpace(int c) { return isspace(c); }
+
+class HardwareSerial : public Stream {
+public:
+    bool quiet = false;
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { if (!quiet) fputc(c, stderr); return 1; }
+    size_t write(const uint8_t* buf, size_t n) override { if (!quiet) fwrite(buf, 1, n, stderr); return n; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    uint32_t getMinFreeHeap() { return 180 * 1024; }
+    uint32_t getHeapSize() { return 320 * 1024; }
+    uint32_t getFreePsram() { return heap_caps_get_free_size(MALLOC_CAP_SPIRAM); }
+    uint32_t getPsramSize() { return HOST_PSRAM_SIZE; }
+    uint32_t getMaxAllocHeap() { return 100 * 1024; }
+    uint32_t getMaxAllocPsram() { return heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM); }
+    uint32_t getCycleCount() { return (uint32_t)(host::nowMicros * 240); }
+    void restart() { exit(0); }
+};
+extern EspClass ESP;
+
+inline float temperatureRead() { return 42.0f; }
@@ -0,0 +1,35 @@
+#pragma once
+#include <Adafruit_GFX.h>
+
+// --- Host-Shim: HUB75-Panel als Null-Sink ---
+// Nimmt alle Pixel an und zählt sie nur. Das gezeigte Bild liefert DisplayManager::captureFrame().
+struct HUB75_I2S_CFG {
+    struct i2s_pins { int8_t r1, g1, b1, r2, g2, b2, a, b, c, d, e, lat, oe, clk; };
+    uint16_t mx_width, mx_height, chain_length;
+    i2s_pins gpio = {};
+    bool clkphase = true;
+    bool double_buff = false;
+
+    HUB75_I2S_CFG(uint16_t w = 64, uint16_t h = 32, uint16_t chain = 1) : mx_width(w), mx_height(h), chain_length(chain) {}
+};
+
+class MatrixPanel_I2S_DMA : public Adafruit_GFX {
+private:
+    uint8_t brightness = 128;
+    uint32_t pushedPixels = 0;
+
+public:
+    explicit MatrixPanel_I2S_DMA(const HUB75_I2S_CFG& cfg) : Adafruit_GFX(cfg.mx_width * cfg.chain_length, cfg.mx_height) {}
+
+    bool begin() { return true; }
+    void setBrightness8(uint8_t b) { brightness = b; }
+    uint8_t getBrightness() { return brightness; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override { pushedPixels++; }
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h) { pushedPixels += w * h; }
+    void clearScreen() {}
+    void flipDMABuffer() {}
+
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+    uint32_t getPushedPixels() { return pushedPixels; }
+};
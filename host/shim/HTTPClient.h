@@ -0,0 +1,26 @@
+#pragma once
+#include <WiFi.h>
+
+// --- Host-Shim: HTTPClient ohne Verbindung ---
+#define HTTP_CODE_OK 200
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient&, const String&) { return false; }
+    bool begin(const String&) { return false; }
+    void setUserAgent(const String&) {}
+    void collectHeaders(const char**, size_t) {}
+    void setTimeout(uint16_t) {}
+    void setConnectTimeout(int32_t) {}
+    void setReuse(bool) {}
+    int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    int writeToStream(Stream*) { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    int getSize() { return -1; }
+    String header(const char*) { return String(); }
+    void end() {}
+};
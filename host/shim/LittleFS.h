@@ -0,0 +1,75 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+// --- Host-Shim: LittleFS auf einem Verzeichnis ---
+// Pfade wie "/icons/1.bmp" werden relativ zu LittleFS.setRoot() aufgelöst.
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FileImpl;
+
+class File : public Stream {
+private:
+    std::shared_ptr<FileImpl> impl;
+
+public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> i) : impl(i) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t n) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buf, size_t n);
+    size_t readBytes(char* buf, size_t n) override { return read((uint8_t*)buf, n); }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush() override;
+    void close();
+    operator bool() const;
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory() const;
+    File openNextFile(const char* mode = "r");
+    void rewindDirectory();
+    time_t getLastWrite();
+};
+
+class FS {
+private:
+    std::string root = ".";
+
+public:
+    void setRoot(const std::string& dir) { root = dir; }
+    std::string hostPath(const String& path) const;
+
+    bool begin(bool formatOnFail = false) { return true; }
+    void end() {}
+    bool format() { return false; }
+    File open(const String& path, const char* mode = "r", bool create = false);
+    File open(const char* path, const char* mode = "r", bool create = false) { return open(String(path), mode, create); }
+    bool exists(const String& path);
+    bool remove(const String& path);
+    bool rename(const String& from, const String& to);
+    bool mkdir(const String& path);
+    bool rmdir(const String& path);
+    size_t totalBytes() { return 1536 * 1024; }
+    size_t usedBytes();
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+extern fs::FS LittleFS;
@@ -0,0 +1,71 @@
+#pragma once
+#include <stdarg.h>
+#include "WString.h"
+
+// --- Host-Shim: Print und Stream ---
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t n) { size_t r = 0; while (n--) r += write(*buf++); return r; }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buf, size_t n) { return write((const uint8_t*)buf, n); }
+    virtual void flush() {}
+
+    size_t print(const String& s) { return write(s.c_str(), s.length()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int base = DEC) { return print(String(v, base)); }
+    size_t print(int v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned int v, int base = DEC) { return print(String(v, base)); }
+    size_t print(long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(long long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(unsigned long long v, int base = DEC) { return print(String(v, base)); }
+    size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T> size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n < 0) return 0;
+        if ((size_t)n < sizeof(buf)) return write((const uint8_t*)buf, n);
+        std::string big(n + 1, 0);
+        va_start(args, fmt);
+        vsnprintf(&big[0], big.size(), fmt, args);
+        va_end(args);
+        return write((const uint8_t*)big.data(), n);
+    }
+};
+
+class Stream : public Print {
+protected:
+    unsigned long _timeout = 1000;
+
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { _timeout = ms; }
+    virtual size_t readBytes(char* buf, size_t n) {
+        size_t got = 0;
+        while (got < n) { int c = read(); if (c < 0) break; buf[got++] = (char)c; }
+        return got;
+    }
+    size_t readBytes(uint8_t* buf, size_t n) { return readBytes((char*)buf, n); }
+    String readString() { String s; int c; while ((c = read()) >= 0) s += (char)c; return s; }
+    String readStringUntil(char term) { String s; int c; while ((c = read()) >= 0 && c != term) s += (char)c; return s; }
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+// --- Host-Shim: Arduino String auf std::string ---
+// Deckt die Teile der Arduino-API ab, die Matrix OS und ArduinoJson benutzen.
+class __FlashStringHelper;
+
+class String {
+private:
+    std::string s;
+
+    static std::string fromInt(long long v, int base) {
+        if (base == 10) return std::to_string(v);
+        return fromUInt((unsigned long long)v, base);
+    }
+    static std::string fromUInt(unsigned long long v, int base) {
+        if (base == 10) return std::to_string(v);
+        std::string out;
+        do { int d = v % base; out.insert(out.begin(), d < 10 ? '0' + d : 'a' + d - 10); v /= base; } while (v);
+        return out;
+    }
+    static std::string fromFloat(double v, int decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        return buf;
+    }
+
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    explicit String(const std::string& c) : s(c) {}
+    String(const __FlashStringHelper* c) : s(c ? reinterpret_cast<const char*>(c) : "") {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) : s(fromUInt(v, base)) {}
+    explicit String(int v, unsigned char base = 10) : s(fromInt(v, base)) {}
+    explicit String(unsigned int v, unsigned char base = 10) : s(fromUInt(v, base)) {}
+    explicit String(long v, unsigned char base = 10) : s(fromInt(v, base)) {}
+    explicit String(unsigned long v, unsigned char base = 10) : s(fromUInt(v, base)) {}
+    explicit String(long long v, unsigned char base = 10) : s(fromInt(v, base)) {}
+    explicit String(unsigned long long v, unsigned char base = 10) : s(fromUInt(v, base)) {}
+    explicit String(float v, unsigned int decimals = 2) : s(fromFloat(v, decimals)) {}
+    explicit String(double v, unsigned int decimals = 2) : s(fromFloat(v, decimals)) {}
+
+    unsigned int length() const { return s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    const char* c_str() const { return s.c_str(); }
+    bool reserve(unsigned int n) { s.reserve(n); return true; }
+
+    char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    void setCharAt(unsigned int i, char c) { if (i < s.size()) s[i] = c; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { static char dummy; return i < s.size() ? s[i] : (dummy = 0); }
+    void getBytes(unsigned char* buf, unsigned int size, unsigned int index = 0) const { toCharArray((char*)buf, size, index); }
+    void toCharArray(char* buf, unsigned int size, unsigned int index = 0) const {
+        if (!size || !buf) return;
+        size_t n = index < s.size() ? std::min<size_t>(s.size() - index, size - 1) : 0;
+        if (n) memcpy(buf, s.data() + index, n);
+        buf[n] = 0;
+    }
+
+    // --- Suchen ---
+    int indexOf(char c, unsigned int from = 0) const { size_t p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(const String& str, unsigned int from = 0) const { size_t p = s.find(str.s, from); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { size_t p = s.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c, unsigned int from) const { size_t p = s.rfind(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(const String& str) const { size_t p = s.rfind(str.s); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(const String& str, unsigned int from) const { size_t p = s.rfind(str.s, from); return p == std::string::npos ? -1 : (int)p; }
+    bool startsWith(const String& p) const { return s.compare(0, p.s.size(), p.s) == 0 && s.size() >= p.s.size(); }
+    bool startsWith(const String& p, unsigned int offset) const { return offset <= s.size() && s.compare(offset, p.s.size(), p.s) == 0 && s.size() - offset >= p.s.size(); }
+    bool endsWith(const String& p) const { return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0; }
+
+    String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, std::min<size_t>(to, s.size()) - from));
+    }
+
+    // --- Vergleichen ---
+    int compareTo(const String& o) const { return strcmp(s.c_str(), o.s.c_str()); }
+    bool equals(const String& o) const { return s == o.s; }
+    bool equals(const char* o) const { return s == (o ? o : ""); }
+    bool equalsIgnoreCase(const String& o) const { return s.size() == o.s.size() && strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* o) const { return equals(o); }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator!=(const char* o) const { return !equals(o); }
+    bool operator<(const String& o) const { return s < o.s; }
+    bool operator>(const String& o) const { return s > o.s; }
+    bool operator<=(const String& o) const { return s <= o.s; }
+    bool operator>=(const String& o) const { return s >= o.s; }
+
+    // --- Verändern ---
+    void replace(char from, char to) { for (char& c : s) if (c == from) c = to; }
+    void replace(const String& from, const String& to) {
+        if (from.s.empty()) return;
+        size_t p = 0;
+        while ((p = s.find(from.s, p)) != std::string::npos) { s.replace(p, from.s.size(), to.s); p += to.s.size(); }
+    }
+    void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+    void toLowerCase() { for (char& c : s) c = tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = toupper((unsigned char)c); }
+    void trim() {
+        size_t a = 0, b = s.size();
+        while (a < b && isspace((unsigned char)s[a])) a++;
+        while (b > a && isspace((unsigned char)s[b - 1])) b--;
+        s = s.substr(a, b - a);
+    }
+
+    // --- Umwandeln ---
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return (float)atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+
+    // --- Anhängen ---
+    bool concat(const String& o) { s += o.s; return true; }
+    bool concat(const char* o) { if (!o) return false; s += o; return true; }
+    bool concat(const char* o, unsigned int n) { if (!o) return false; s.append(o, n); return true; }
+    bool concat(char c) { s += c; return true; }
+    bool concat(unsigned char v) { s += fromUInt(v, 10); return true; }
+    bool concat(int v) { s += fromInt(v, 10); return true; }
+    bool concat(unsigned int v) { s += fromUInt(v, 10); return true; }
+    bool concat(long v) { s += fromInt(v, 10); return true; }
+    bool concat(unsigned long v) { s += fromUInt(v, 10); return true; }
+    bool concat(float v) { s += fromFloat(v, 2); return true; }
+    bool concat(double v) { s += fromFloat(v, 2); return true; }
+    bool concat(const __FlashStringHelper* o) { return concat(reinterpret_cast<const char*>(o)); }
+    template <typename T> String& operator+=(const T& v) { concat(v); return *this; }
+
+    char* begin() { return &s[0]; }
+    char* end() { return &s[0] + s.size(); }
+    const char* begin() const { return s.data(); }
+    const char* end() const { return s.data() + s.size(); }
+};
+
+// ArduinoJson erkennt temporäre Summen über diesen Typ
+class StringSumHelper : public String {
+public:
+    using String::String;
+    StringSumHelper(const String& s) : String(s) {}
+};
+
+template <typename T> inline StringSumHelper operator+(const String& a, const T& b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(const char* a, const String& b) { StringSumHelper r(a); r.concat(b); return r; }
+inline StringSumHelper operator+(char a, const String& b) { StringSumHelper r; r.concat(a); r.concat(b); return r; }
+inline bool operator==(const char* a, const String& b) { return b == a; }
+inline bool operator!=(const char* a, const String& b) { return b != a; }
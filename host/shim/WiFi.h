@@ -0,0 +1,138 @@
+#pragma once
+#include <Arduino.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+// --- Host-Shim: Netzwerk ---
+// Standardmäßig offline: WiFi.status() meldet keine Verbindung, Downloads (LaMetric-Icons) schlagen sauber fehl.
+// Mit WiFi.setConnected(true) spricht WiFiClient echtes TCP (nicht blockierend, nur http://),
+// z.B. gegen einen lokalen "python3 -m http.server" als Icon-Quelle.
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class IPAddress {
+public:
+    String toString() const { return "0.0.0.0"; }
+    bool fromString(const String&) { return false; }
+};
+
+class WiFiClient : public Stream {
+private:
+    int fd = -1;
+    bool eof = false;
+    int peeked = -1;
+
+    // Wartet ohne Verbrauch auf Daten; false = nichts da (oder Verbindung zu, dann eof)
+    bool poll0() {
+        if (fd < 0 || eof) return false;
+        struct pollfd p = { fd, POLLIN, 0 };
+        if (::poll(&p, 1, 0) <= 0) return false;
+        char c;
+        ssize_t n = ::recv(fd, &c, 1, MSG_PEEK);
+        if (n <= 0) { if (n == 0 || errno != EAGAIN) eof = true; return false; }
+        return true;
+    }
+
+public:
+    virtual ~WiFiClient() { stop(); }
+
+    int connect(const char* host, uint16_t port) { return connect(host, port, 3000); }
+    int connect(const char* host, uint16_t port, int32_t timeoutMs) {
+        stop();
+        struct addrinfo hints = {}, *res = nullptr;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(host, String(port).c_str(), &hints, &res) != 0 || !res) return 0;
+        for (struct addrinfo* a = res; a && fd < 0; a = a->ai_next) {
+            int s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (s < 0) continue;
+            fcntl(s, F_SETFL, fcntl(s, F_GETFL) | O_NONBLOCK);
+            int r = ::connect(s, a->ai_addr, a->ai_addrlen);
+            if (r < 0 && errno == EINPROGRESS) {
+                struct pollfd p = { s, POLLOUT, 0 };
+                int err = 0; socklen_t len = sizeof(err);
+                r = (::poll(&p, 1, timeoutMs) == 1 && getsockopt(s, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0) ? 0 : -1;
+            }
+            if (r == 0) fd = s; else ::close(s);
+        }
+        freeaddrinfo(res);
+        eof = false;
+        peeked = -1;
+        return fd >= 0;
+    }
+
+    void stop() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        peeked = -1;
+    }
+
+    uint8_t connected() { return fd >= 0 && (peeked >= 0 || poll0() || !eof); }
+    void setNoDelay(bool) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t n) override {
+        size_t sent = 0;
+        while (fd >= 0 && sent < n) {
+            ssize_t r = ::send(fd, buf + sent, n - sent, MSG_NOSIGNAL);
+            if (r > 0) { sent += r; continue; }
+            if (r < 0 && errno == EAGAIN) { struct pollfd p = { fd, POLLOUT, 0 }; ::poll(&p, 1, 100); continue; }
+            break;
+        }
+        return sent;
+    }
+    using Print::write;
+
+    int available() override {
+        if (peeked >= 0) return 1;
+        if (!poll0()) return 0;
+        int n = 0;
+        char buf[4096];
+        ssize_t r = ::recv(fd, buf, sizeof(buf), MSG_PEEK | MSG_DONTWAIT);
+        if (r > 0) n = (int)r;
+        return n;
+    }
+
+    int read(uint8_t* buf, size_t size) {
+        if (size == 0 || fd < 0) return 0;
+        size_t got = 0;
+        if (peeked >= 0) { buf[got++] = (uint8_t)peeked; peeked = -1; }
+        if (got < size) {
+            ssize_t r = ::recv(fd, buf + got, size - got, MSG_DONTWAIT);
+            if (r > 0) got += r;
+            else if (r == 0) eof = true;
+        }
+        return got ? (int)got : -1;
+    }
+
+    int read() override {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+
+    int peek() override {
+        if (peeked < 0) {
+            uint8_t c;
+            if (fd >= 0 && ::recv(fd, &c, 1, MSG_DONTWAIT) == 1) peeked = c;
+        }
+        return peeked;
+    }
+
+    operator bool() { return connected(); }
+};
+
+class WiFiClass {
+private:
+    bool up = false;
+
+public:
+    void setConnected(bool c) { up = c; }
+    int status() { return up ? WL_CONNECTED : WL_DISCONNECTED; }
+    IPAddress localIP() { return IPAddress(); }
+    long RSSI() { return 0; }
+};
+extern WiFiClass WiFi;
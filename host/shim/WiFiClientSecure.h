@@ -0,0 +1,11 @@
+#pragma once
+#include <WiFi.h>
+
+// Kein TLS im Host-Build: https-Verbindungen schlagen fehl
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setHandshakeTimeout(unsigned long) {}
+    int connect(const char*, uint16_t) { return 0; }
+    int connect(const char*, uint16_t, int32_t) { return 0; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Host-Shim: PSRAM-Allocator auf malloc ---
+// Mit host::psramModel = true (vor der ersten Anforderung) kommt MALLOC_CAP_SPIRAM aus einem nachgebildeten
+// 8-MB-Heap: First-Fit, freie Nachbarn werden verschmolzen. Freier Speicher und größter freier Block sind
+// dann echte Werte, z.B. für den Fragmentierungs-Dauertest (matrix_host --soak).
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DMA      (1 << 3)
+
+#define HOST_PSRAM_SIZE (8 * 1024 * 1024)
+
+namespace host {
+    extern bool psramModel;
+    void* psramAlloc(size_t size);
+    void* psramRealloc(void* ptr, size_t size);
+    bool psramOwns(const void* ptr);
+    void psramRelease(void* ptr);
+    size_t psramFreeSize();
+    size_t psramLargestFree();
+}
+
+inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return host::psramModel && (caps & MALLOC_CAP_SPIRAM) ? host::psramAlloc(size) : malloc(size);
+}
+inline void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    if (!host::psramModel || !(caps & MALLOC_CAP_SPIRAM)) return calloc(n, size);
+    void* p = host::psramAlloc(n * size);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+inline void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    if (host::psramOwns(ptr) || (!ptr && host::psramModel && (caps & MALLOC_CAP_SPIRAM))) return host::psramRealloc(ptr, size);
+    return realloc(ptr, size);
+}
+inline void heap_caps_free(void* ptr) {
+    if (host::psramOwns(ptr)) host::psramRelease(ptr);
+    else free(ptr);
+}
+inline size_t heap_caps_get_free_size(uint32_t caps) { return host::psramModel ? host::psramFreeSize() : HOST_PSRAM_SIZE; }
+inline size_t heap_caps_get_total_size(uint32_t caps) { return HOST_PSRAM_SIZE; }
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) { return host::psramModel ? host::psramLargestFree() : HOST_PSRAM_SIZE; }
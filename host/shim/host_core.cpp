@@ -0,0 +1,248 @@
+// --- Host-Shim: Implementierungen für Arduino-Kern, LittleFS und Netzwerk-Attrappen ---
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <WiFi.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+namespace host {
+    uint64_t nowMicros = 0;
+    bool psramModel = false;
+}
+
+// --- PSRAM-Modell (siehe esp_heap_caps.h) ---
+// Jeder Block kostet wie auf dem Gerät einen Kopf und wird auf 8 Byte aufgerundet.
+namespace host {
+
+static const size_t PSRAM_BLOCK_HEADER = 8;
+static uint8_t* psramBase = nullptr;
+// Die Tabellen werden nie abgebaut: globale Objekte (iconManager) geben ihren PSRAM erst nach main() frei
+static std::map<size_t, size_t>& psramFreeBlocks = *new std::map<size_t, size_t>();   // Offset -> Größe, nach Adresse sortiert
+static std::unordered_map<size_t, size_t>& psramUsedBlocks = *new std::unordered_map<size_t, size_t>();
+
+bool psramOwns(const void* ptr) {
+    return psramBase && ptr >= psramBase && ptr < psramBase + HOST_PSRAM_SIZE;
+}
+
+void* psramAlloc(size_t size) {
+    if (!psramBase) {
+        psramBase = (uint8_t*)malloc(HOST_PSRAM_SIZE);
+        if (!psramBase) return nullptr;
+        psramFreeBlocks[0] = HOST_PSRAM_SIZE;
+    }
+    size_t need = ((size + 7) & ~(size_t)7) + PSRAM_BLOCK_HEADER;
+    for (auto it = psramFreeBlocks.begin(); it != psramFreeBlocks.end(); ++it) {
+        if (it->second < need) continue;
+        size_t offset = it->first, rest = it->second - need;
+        psramFreeBlocks.erase(it);
+        if (rest) psramFreeBlocks[offset + need] = rest;
+        psramUsedBlocks[offset] = need;
+        return psramBase + offset + PSRAM_BLOCK_HEADER;
+    }
+    return nullptr;
+}
+
+void psramRelease(void* ptr) {
+    size_t offset = (uint8_t*)ptr - psramBase - PSRAM_BLOCK_HEADER;
+    auto used = psramUsedBlocks.find(offset);
+    if (used == psramUsedBlocks.end()) { fprintf(stderr, "PSRAM-Modell: ungültiges free(%p)\n", ptr); abort(); }
+    size_t size = used->second;
+    psramUsedBlocks.erase(used);
+
+    auto next = psramFreeBlocks.lower_bound(offset);
+    if (next != psramFreeBlocks.end() && next->first == offset + size) {
+        size += next->second;
+        next = psramFreeBlocks.erase(next);
+    }
+    if (next != psramFreeBlocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) { prev->second += size; return; }
+    }
+    psramFreeBlocks[offset] = size;
+}
+
+void* psramRealloc(void* ptr, size_t size) {
+    if (!ptr) return psramAlloc(size);
+    size_t old = psramUsedBlocks[(uint8_t*)ptr - psramBase - PSRAM_BLOCK_HEADER] - PSRAM_BLOCK_HEADER;
+    void* grown = psramAlloc(size);
+    if (!grown) return nullptr;
+    memcpy(grown, ptr, old < size ? old : size);
+    psramRelease(ptr);
+    return grown;
+}
+
+size_t psramFreeSize() {
+    if (!psramBase) return HOST_PSRAM_SIZE;
+    size_t total = 0;
+    for (const auto& b : psramFreeBlocks) total += b.second;
+    return total;
+}
+
+size_t psramLargestFree() {
+    if (!psramBase) return HOST_PSRAM_SIZE;
+    size_t largest = 0;
+    for (const auto& b : psramFreeBlocks) largest = std::max(largest, b.second);
+    return largest > PSRAM_BLOCK_HEADER ? largest - PSRAM_BLOCK_HEADER : 0;
+}
+
+} // namespace host
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+fs::FS LittleFS;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* arg, unsigned, TaskHandle_t* handle, int) {
+    std::thread(fn, arg).detach();
+    if (handle) *handle = nullptr;
+    return pdPASS;
+}
+
+// --- Zufall: xorshift32, fester Startwert ---
+static uint32_t rngState = 0x2545F491;
+
+void randomSeed(unsigned long seed) { rngState = seed ? seed : 0x2545F491; }
+
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+long random(long howBig) { return howBig > 0 ? (long)(nextRandom() % (uint32_t)howBig) : 0; }
+long random(long howSmall, long howBig) { return howBig > howSmall ? howSmall + random(howBig - howSmall) : howSmall; }
+
+// --- LittleFS auf einem Verzeichnis ---
+namespace fs {
+
+struct FileImpl {
+    FILE* fp = nullptr;
+    std::string path;       // LittleFS-Pfad
+    std::string hostPath;
+    std::string name;
+    bool dir = false;
+    std::vector<std::string> entries;
+    size_t nextEntry = 0;
+
+    ~FileImpl() { if (fp) fclose(fp); }
+};
+
+std::string FS::hostPath(const String& path) const {
+    std::string p = path.c_str();
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return root + p;
+}
+
+File FS::open(const String& path, const char* mode, bool create) {
+    std::string hp = hostPath(path);
+    struct stat st;
+    bool isDir = stat(hp.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    auto impl = std::make_shared<FileImpl>();
+    impl->path = path.c_str();
+    impl->hostPath = hp;
+    size_t slash = impl->path.find_last_of('/');
+    impl->name = slash == std::string::npos ? impl->path : impl->path.substr(slash + 1);
+
+    if (isDir) {
+        impl->dir = true;
+        if (DIR* d = opendir(hp.c_str())) {
+            while (struct dirent* e = readdir(d)) {
+                if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) impl->entries.push_back(e->d_name);
+            }
+            closedir(d);
+        }
+        std::sort(impl->entries.begin(), impl->entries.end());
+        return File(impl);
+    }
+
+    std::string m = mode ? mode : "r";
+    if (m.find('b') == std::string::npos) m += "b";
+    impl->fp = fopen(hp.c_str(), m.c_str());
+    if (!impl->fp) return File();
+    return File(impl);
+}
+
+bool FS::exists(const String& path) { struct stat st; return stat(hostPath(path).c_str(), &st) == 0; }
+bool FS::remove(const String& path) { return ::remove(hostPath(path).c_str()) == 0; }
+bool FS::rename(const String& from, const String& to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+bool FS::mkdir(const String& path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+bool FS::rmdir(const String& path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+
+size_t FS::usedBytes() {
+    size_t used = 0;
+    File dir = open("/");
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile()) used += f.size();
+    return used;
+}
+
+size_t File::write(uint8_t c) { return (impl && impl->fp) ? fwrite(&c, 1, 1, impl->fp) : 0; }
+size_t File::write(const uint8_t* buf, size_t n) { return (impl && impl->fp) ? fwrite(buf, 1, n, impl->fp) : 0; }
+
+int File::available() {
+    if (!impl || !impl->fp) return 0;
+    long pos = ftell(impl->fp);
+    return (int)(size() - (pos < 0 ? 0 : pos));
+}
+
+int File::read() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if (c == EOF) return -1;
+    ungetc(c, impl->fp);
+    return c;
+}
+
+size_t File::read(uint8_t* buf, size_t n) { return (impl && impl->fp) ? fread(buf, 1, n, impl->fp) : 0; }
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!impl || !impl->fp) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+    return fseek(impl->fp, pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!impl || !impl->fp) return 0;
+    long pos = ftell(impl->fp);
+    return pos < 0 ? 0 : pos;
+}
+
+size_t File::size() const {
+    if (!impl) return 0;
+    if (impl->fp) fflush(impl->fp);
+    struct stat st;
+    return stat(impl->hostPath.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+void File::flush() { if (impl && impl->fp) fflush(impl->fp); }
+void File::close() { impl.reset(); }
+File::operator bool() const { return impl && (impl->fp || impl->dir); }
+const char* File::name() const { return impl ? impl->name.c_str() : ""; }
+const char* File::path() const { return impl ? impl->path.c_str() : ""; }
+bool File::isDirectory() const { return impl && impl->dir; }
+
+File File::openNextFile(const char* mode) {
+    if (!impl || !impl->dir || impl->nextEntry >= impl->entries.size()) return File();
+    std::string base = impl->path;
+    if (base.empty() || base.back() != '/') base += "/";
+    return LittleFS.open(String(base + impl->entries[impl->nextEntry++]), mode);
+}
+
+void File::rewindDirectory() { if (impl) impl->nextEntry = 0; }
+
+time_t File::getLastWrite() {
+    struct stat st;
+    return (impl && stat(impl->hostPath.c_str(), &st) == 0) ? st.st_mtime : 0;
+}
+
+} // namespace fs